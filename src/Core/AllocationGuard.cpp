@@ -0,0 +1,49 @@
+#include "AllocationGuard.h"
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+#if VOID_ALLOCATION_GUARD
+
+namespace
+{
+    thread_local int noAllocationDepth = 0;
+
+    void checkAllocationAllowed()
+    {
+        if (noAllocationDepth > 0)
+        {
+            // Clear the depth while reporting so the assertion's own logging can allocate
+            const auto depth = std::exchange(noAllocationDepth, 0);
+            jassertfalse; // Heap allocation inside a ScopedNoAllocation (audio thread)
+            noAllocationDepth = depth;
+        }
+    }
+}
+
+ScopedNoAllocation::ScopedNoAllocation() { ++noAllocationDepth; }
+ScopedNoAllocation::~ScopedNoAllocation() { --noAllocationDepth; }
+
+// Replacing the single-object forms is enough: the default array and nothrow
+// versions forward to these.
+void* operator new(std::size_t size)
+{
+    checkAllocationAllowed();
+
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+// Heap allocation checks replace the global operator new, which is only well defined in an
+// executable: CMake's VOID_ALLOCATION_GUARD option builds the Standalone with them. In the
+// VST3 or AU module the host's allocator may resolve instead, so they are off there.
+#ifndef VOID_ALLOCATION_GUARD
+ #define VOID_ALLOCATION_GUARD 0
+#endif
+
+/**
+ * ScopedNoAllocation - Debug guard for realtime code.
+ *
+ * While an instance is alive on a thread, any call to the global operator new
+ * on that thread hits a jassert. Place one at the top of processBlock to catch
+ * containers, strings or std::function growing on the audio thread.
+ * Direct malloc calls (e.g. juce::HeapBlock) are not intercepted.
+ * Compiles to nothing when VOID_ALLOCATION_GUARD is 0, which is every plugin
+ * build - there the guard is a no-op.
+ */
+class ScopedNoAllocation
+{
+public:
+   #if VOID_ALLOCATION_GUARD
+    ScopedNoAllocation();
+    ~ScopedNoAllocation();
+   #else
+    ScopedNoAllocation() {}
+    ~ScopedNoAllocation() {}
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE(ScopedNoAllocation)
+};
@@ -0,0 +1,221 @@
+#include "RenderThreadPool.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+    // Idle workers spin for a few microseconds, then yield for a few milliseconds
+    // (long enough to bridge the gap between host blocks), then sleep until woken
+    constexpr int spinRounds = 2048;
+    constexpr int yieldRounds = 4096;
+}
+
+class RenderThreadPool::Worker : public juce::Thread
+{
+public:
+    Worker(RenderThreadPool& owner, int participantIndex)
+        : juce::Thread("Render Worker " + juce::String(participantIndex)),
+          pool(owner),
+          participant(participantIndex)
+    {
+    }
+
+    void run() override
+    {
+        juce::ScopedNoDenormals noDenormals;
+
+        Batch batch;
+        juce::uint64 lastBatch = 0;
+
+        while (pool.waitForBatch(*this, lastBatch, batch))
+        {
+            lastBatch = batch.number;
+            pool.work(batch, participant);
+        }
+    }
+
+    std::atomic<bool> sleeping { false };
+    juce::WaitableEvent wakeUp;
+
+private:
+    RenderThreadPool& pool;
+    const int participant;
+};
+
+RenderThreadPool::RenderThreadPool() {}
+
+RenderThreadPool::~RenderThreadPool()
+{
+    stop();
+}
+
+void RenderThreadPool::start(int numWorkers, int samplesPerBlock, double sampleRate)
+{
+    stop();
+
+    numWorkers = juce::jlimit(0, maxTasks - 1, numWorkers);
+    for (int i = 0; i < numWorkers; ++i)
+        workers.add(new Worker(*this, i + 1)); // Participant 0 is the calling thread
+
+    numParticipants = numWorkers + 1;
+
+    const auto options = juce::Thread::RealtimeOptions()
+                             .withApproximateAudioProcessingTime(juce::jmax(1, samplesPerBlock),
+                                                                 juce::jmax(1.0, sampleRate));
+
+    for (auto* worker : workers)
+        if (!worker->startRealtimeThread(options))
+            worker->startThread(juce::Thread::Priority::highest); // No realtime permission
+}
+
+void RenderThreadPool::stop()
+{
+    for (auto* worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->wakeUp.signal();
+    }
+
+    for (auto* worker : workers)
+        worker->stopThread(1000);
+
+    workers.clear();
+    numParticipants = 1;
+}
+
+void RenderThreadPool::run(Task task, void* context, int numTasks)
+{
+    jassert(numTasks <= maxTasks);
+    numTasks = juce::jmin(numTasks, maxTasks);
+
+    if (numTasks <= 0)
+        return;
+
+    if (workers.isEmpty() || numTasks == 1)
+    {
+        for (int i = 0; i < numTasks; ++i)
+            task(context, i);
+        return;
+    }
+
+    // Publish the batch: odd sequence while writing, even once complete
+    const juce::uint64 number = sequence.load(std::memory_order_relaxed) / 2 + 1;
+    sequence.store(number * 2 - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    batchTask.store(task, std::memory_order_relaxed);
+    batchContext.store(context, std::memory_order_relaxed);
+    batchNumTasks.store(numTasks, std::memory_order_relaxed);
+    tasksRemaining.store(numTasks, std::memory_order_relaxed);
+
+    sequence.store(number * 2);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // The only lock on this path: waking a worker that went to sleep after a long idle spell
+    for (auto* worker : workers)
+        if (worker->sleeping.load())
+            worker->wakeUp.signal();
+
+    work({ task, context, numTasks, number }, 0);
+
+    // Whatever is left is already running on a worker
+    for (int round = 0; tasksRemaining.load(std::memory_order_acquire) > 0; ++round)
+    {
+        if (round < spinRounds)
+            pause();
+        else
+            juce::Thread::yield();
+    }
+}
+
+bool RenderThreadPool::readBatch(Batch& batch) const
+{
+    const auto before = sequence.load(std::memory_order_acquire);
+    if ((before & 1) != 0)
+        return false;
+
+    batch.task = batchTask.load(std::memory_order_relaxed);
+    batch.context = batchContext.load(std::memory_order_relaxed);
+    batch.numTasks = batchNumTasks.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence.load(std::memory_order_relaxed) != before)
+        return false;
+
+    batch.number = before / 2;
+    return true;
+}
+
+bool RenderThreadPool::waitForBatch(Worker& worker, juce::uint64 lastBatch, Batch& batch) const
+{
+    for (int round = 0; round < spinRounds + yieldRounds && !worker.threadShouldExit(); ++round)
+    {
+        if (readBatch(batch) && batch.number > lastBatch)
+            return true;
+
+        if (round < spinRounds)
+            pause();
+        else
+            juce::Thread::yield();
+    }
+
+    // Sleep until run() or stop() signals. run() publishes the batch before it reads the
+    // flag and the worker sets the flag before it reads the batch, so with both ordered
+    // by the fence one of them always sees the other: no timeout needed.
+    worker.sleeping.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    while (!worker.threadShouldExit())
+    {
+        if (readBatch(batch) && batch.number > lastBatch)
+        {
+            worker.sleeping.store(false);
+            return true;
+        }
+
+        worker.wakeUp.wait(-1);
+    }
+
+    worker.sleeping.store(false);
+    return false;
+}
+
+void RenderThreadPool::work(const Batch& batch, int participant)
+{
+    // Own share first, then steal anything the other participants haven't started.
+    // A worker holding an outdated batch can't claim anything: all of that
+    // batch's tasks were claimed before run() returned.
+    for (int i = participant; i < batch.numTasks; i += numParticipants)
+        tryRun(batch, i);
+
+    for (int offset = 1; offset < batch.numTasks; ++offset)
+        tryRun(batch, (participant + offset) % batch.numTasks);
+}
+
+void RenderThreadPool::tryRun(const Batch& batch, int taskIndex)
+{
+    auto& claim = claims[(size_t) taskIndex];
+    auto claimedBy = claim.load(std::memory_order_relaxed);
+
+    while (claimedBy < batch.number)
+    {
+        if (claim.compare_exchange_weak(claimedBy, batch.number,
+                                        std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            batch.task(batch.context, taskIndex);
+            tasksRemaining.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+void RenderThreadPool::pause() noexcept
+{
+   #if JUCE_INTEL
+    _mm_pause();
+   #elif JUCE_ARM && (JUCE_GCC || JUCE_CLANG)
+    __asm__ __volatile__ ("yield");
+   #endif
+}
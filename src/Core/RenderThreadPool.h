@@ -0,0 +1,80 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+/**
+ * RenderThreadPool - Small realtime worker pool for the audio thread.
+ *
+ * run() hands a batch of independent tasks to the workers and returns once
+ * every task has finished. The calling thread works on the batch too, so a
+ * batch always completes, even if no worker gets scheduled in time.
+ *
+ * Nothing on the run() path allocates, and it only locks to wake a sleeping worker:
+ *  - a batch is published through a sequence counter (seqlock), so workers
+ *    never see a half-written batch
+ *  - every participant starts with its own share of the tasks and then steals
+ *    whatever the others haven't started; a task is claimed with one CAS
+ *  - idle workers spin, then yield for a few milliseconds, and then sleep
+ *    until the next batch, so back-to-back batches are picked up without a
+ *    wake-up while an unused pool costs no CPU. Waking a sleeper signals a
+ *    juce::WaitableEvent, which takes its mutex briefly.
+ *
+ * Tasks must not depend on which thread runs them. Callers that want a
+ * deterministic result give every task its own output and combine those in
+ * a fixed order after run() returns.
+ */
+class RenderThreadPool
+{
+public:
+    using Task = void (*)(void* context, int taskIndex);
+
+    static constexpr int maxTasks = 32;
+
+    RenderThreadPool();
+    ~RenderThreadPool();
+
+    // Starts numWorkers realtime threads, replacing any running ones.
+    // Call from prepareToPlay - never from the audio thread.
+    void start(int numWorkers, int samplesPerBlock, double sampleRate);
+    void stop();
+
+    int getNumWorkers() const { return workers.size(); }
+
+    // Runs task(context, i) for every i in [0, numTasks) and waits for all of them
+    void run(Task task, void* context, int numTasks);
+
+private:
+    class Worker;
+
+    struct Batch
+    {
+        Task task = nullptr;
+        void* context = nullptr;
+        int numTasks = 0;
+        juce::uint64 number = 0;
+    };
+
+    juce::OwnedArray<Worker> workers;
+    int numParticipants = 1; // Workers plus the thread calling run()
+
+    // Current batch; sequence is odd while the fields are being written and
+    // 2 * batch number once they are published
+    std::atomic<juce::uint64> sequence { 0 };
+    std::atomic<Task> batchTask { nullptr };
+    std::atomic<void*> batchContext { nullptr };
+    std::atomic<int> batchNumTasks { 0 };
+
+    // Number of the last batch that claimed each task slot
+    std::array<std::atomic<juce::uint64>, maxTasks> claims;
+    std::atomic<int> tasksRemaining { 0 };
+
+    bool readBatch(Batch& batch) const;
+    bool waitForBatch(Worker& worker, juce::uint64 lastBatch, Batch& batch) const;
+    void work(const Batch& batch, int participant);
+    void tryRun(const Batch& batch, int taskIndex);
+
+    static void pause() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderThreadPool)
+};
@@ -0,0 +1,90 @@
+#include "SmootherBank.h"
+
+SmootherBank::SmootherBank(juce::AudioProcessorValueTreeState& apvts)
+{
+    for (auto* parameter : apvts.processor.getParameters())
+    {
+        if (auto* floatParameter = dynamic_cast<juce::AudioParameterFloat*>(parameter))
+        {
+            Smoother smoother;
+            smoother.source = apvts.getRawParameterValue(floatParameter->getParameterID());
+            jassert(smoother.source != nullptr);
+
+            parameterIDs.add(floatParameter->getParameterID());
+            smoothers.push_back(smoother);
+        }
+    }
+}
+
+void SmootherBank::prepare(double sampleRate, int maximumBlockSize, double rampSeconds)
+{
+    rampLengthSamples = juce::jmax(1, juce::roundToInt(sampleRate * rampSeconds));
+    rampBuffer.assign((size_t) juce::jmax(1, maximumBlockSize), 0.0f);
+    lastBlockSize = 0;
+
+    for (auto& smoother : smoothers)
+    {
+        smoother.current = smoother.target = smoother.source->load(std::memory_order_relaxed);
+        smoother.step = 0.0f;
+        smoother.remaining = 0;
+    }
+}
+
+int SmootherBank::getIndex(const juce::String& parameterID) const
+{
+    const int index = parameterIDs.indexOf(parameterID);
+    jassert(index >= 0); // Not a float parameter in createParameterLayout()
+    return index;
+}
+
+void SmootherBank::beginBlock(int numSamples)
+{
+    for (auto& smoother : smoothers)
+    {
+        // Move to the end of the previous block
+        if (smoother.remaining > lastBlockSize)
+        {
+            smoother.current += smoother.step * (float) lastBlockSize;
+            smoother.remaining -= lastBlockSize;
+        }
+        else
+        {
+            smoother.current = smoother.target;
+            smoother.remaining = 0;
+        }
+
+        // A new target restarts the ramp from wherever the value is now
+        const float newTarget = smoother.source->load(std::memory_order_relaxed);
+        if (newTarget != smoother.target)
+        {
+            smoother.target = newTarget;
+            smoother.remaining = rampLengthSamples;
+            smoother.step = (newTarget - smoother.current) / (float) rampLengthSamples;
+        }
+    }
+
+    lastBlockSize = numSamples;
+}
+
+float SmootherBank::getValueAt(int index, int sampleOffset) const
+{
+    const auto& smoother = smoothers[(size_t) index];
+    return sampleOffset < smoother.remaining ? smoother.current + smoother.step * (float) (sampleOffset + 1)
+                                             : smoother.target;
+}
+
+const float* SmootherBank::getRamp(int index, int startSample, int numSamples)
+{
+    jassert(numSamples <= (int) rampBuffer.size());
+
+    const auto& smoother = smoothers[(size_t) index];
+    float* ramp = rampBuffer.data();
+
+    const int rampEnd = juce::jlimit(0, numSamples, smoother.remaining - startSample);
+    const float start = smoother.current + smoother.step * (float) (startSample + 1);
+    for (int i = 0; i < rampEnd; ++i)
+        ramp[i] = start + smoother.step * (float) i;
+
+    std::fill(ramp + rampEnd, ramp + numSamples, smoother.target);
+    return ramp;
+}
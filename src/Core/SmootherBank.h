@@ -0,0 +1,61 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <vector>
+
+/**
+ * SmootherBank - Central per-sample smoothing for every float parameter.
+ *
+ * Each AudioParameterFloat in the processor gets a linear ramp. beginBlock()
+ * reads all targets once per host block; after that the audio path can ask
+ * for any parameter either as a block-constant value (the fast path, taken
+ * whenever isSmoothing() is false) or as a per-sample ramp over any sub-range
+ * of the block, e.g. the MIDI-split chunks the engine renders.
+ *
+ * Indices are resolved by ID once, on the message thread; everything else is
+ * allocation-free and meant for the audio thread.
+ */
+class SmootherBank
+{
+public:
+    explicit SmootherBank(juce::AudioProcessorValueTreeState& apvts);
+
+    // Sizes the ramp buffer and jumps every smoother to its parameter's value
+    void prepare(double sampleRate, int maximumBlockSize, double rampSeconds = 0.02);
+
+    // Index of a float parameter, -1 if it isn't one (message thread)
+    int getIndex(const juce::String& parameterID) const;
+
+    // Advances past the previous block and picks up new targets
+    void beginBlock(int numSamples);
+
+    // True while the parameter is still ramping at the start of the block
+    bool isSmoothing(int index) const { return smoothers[(size_t) index].remaining > 0; }
+
+    // Value at sampleOffset within the current block
+    float getValueAt(int index, int sampleOffset) const;
+    float getTargetValue(int index) const { return smoothers[(size_t) index].target; }
+
+    // Per-sample values for [startSample, startSample + numSamples) of the current block.
+    // The pointer refers to a shared buffer that the next getRamp() call overwrites.
+    const float* getRamp(int index, int startSample, int numSamples);
+
+    int getMaximumBlockSize() const { return (int) rampBuffer.size(); }
+
+private:
+    struct Smoother
+    {
+        std::atomic<float>* source = nullptr;
+        float current = 0.0f; // Value before the first sample of the block
+        float target = 0.0f;
+        float step = 0.0f;    // Per sample while remaining > 0
+        int remaining = 0;    // Ramp samples left from the start of the block
+    };
+
+    juce::StringArray parameterIDs;
+    std::vector<Smoother> smoothers;
+    std::vector<float> rampBuffer;
+    int rampLengthSamples = 1;
+    int lastBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SmootherBank)
+};
@@ -8,6 +8,96 @@ public:
         beginTest("Parameter Layout Validity");
         auto layout = VoidTextureSynthAudioProcessor::createParameterLayout();
         expect(true); // ParameterLayout constructed, parameters added in PluginProcessor.cpp
+
+        beginTest("Voice Pool Allocation");
+        VoidTextureSynthAudioProcessor processor;
+        processor.prepareToPlay(44100.0, 512);
+        auto& engine = processor.synthEngine1;
+
+        juce::AudioBuffer<float> buffer(2, 512);
+        juce::MidiBuffer midi;
+        const auto render = [&](double seconds) {
+            for (int i = 0; i < (int) std::ceil(seconds * 44100.0 / 512.0); ++i)
+                processor.processBlock(buffer, midi);
+        };
+
+        const int lastNote = 40 + SynthEngine1::maxVoices + 3;
+        for (int note = 40; note <= lastNote; ++note)
+            engine.noteOn(note, 0.8f);
+        expectEquals(engine.getNumActiveVoices(), SynthEngine1::maxVoices); // Extra notes steal voices
+
+        // Note-off starts the release; the voice keeps sounding until it has decayed
+        engine.noteOff(lastNote);
+        expectEquals(engine.getNumActiveVoices(), SynthEngine1::maxVoices);
+        expect(engine.getVoiceForNote(lastNote) != nullptr && engine.getVoiceForNote(lastNote)->isReleasing());
+        engine.allNotesOff();
+        expectEquals(engine.getNumActiveVoices(), SynthEngine1::maxVoices);
+        for (int note = lastNote - SynthEngine1::maxVoices + 1; note <= lastNote; ++note)
+            expect(engine.getVoiceForNote(note) != nullptr && engine.getVoiceForNote(note)->isReleasing());
+
+        // Silent voices are retired once their release has run out
+        render(2.5);
+        expectEquals(engine.getNumActiveVoices(), 0);
+
+        beginTest("Voice Stealing Order");
+        for (int note = 40; note < 40 + SynthEngine1::maxVoices; ++note)
+            engine.noteOn(note, 0.8f);
+        render(0.2);
+
+        // Everything playing loud: the oldest note goes
+        engine.noteOn(60, 0.8f);
+        expect(engine.getVoiceForNote(40) == nullptr);
+        render(0.2);
+
+        // The oldest released note goes before an older one that is still held
+        engine.noteOff(45);
+        engine.noteOff(43);
+        render(0.05);
+        engine.noteOn(61, 0.8f);
+        expect(engine.getVoiceForNote(43) == nullptr);
+        expect(engine.getVoiceForNote(41) != nullptr);
+        render(0.2);
+
+        // A voice that has decayed below -60 dB goes first, even before an older released note
+        for (int i = 0; i < 100 && engine.getVoiceForNote(45) != nullptr
+                                && engine.getVoiceForNote(45)->getCurrentLevel() >= 0.001f; ++i)
+            render(0.01);
+        expect(engine.getVoiceForNote(45) != nullptr && engine.getVoiceForNote(45)->isReleasing());
+        engine.noteOff(41);
+        engine.noteOn(62, 0.8f);
+        expect(engine.getVoiceForNote(45) == nullptr);
+        expect(engine.getVoiceForNote(41) != nullptr);
+        expectEquals(engine.getNumActiveVoices(), SynthEngine1::maxVoices);
+
+        engine.allNotesOff();
+        render(2.5);
+
+        beginTest("Envelope Release");
+        const double blockSeconds = 512.0 / 44100.0;
+        const double releaseTime = processor.apvts.getRawParameterValue("releaseTime")->load();
+        engine.noteOn(57, 0.8f);
+        render(0.3);
+        engine.noteOff(57);
+
+        // The release keeps the voice sounding, then the engine retires it once it
+        // has fallen to silence, which the envelope reaches in releaseTime
+        bool soundedInRelease = true;
+        double retiredAfter = 0.0;
+        while (engine.getVoiceForNote(57) != nullptr && retiredAfter < 3.0 * releaseTime)
+        {
+            processor.processBlock(buffer, midi);
+            retiredAfter += blockSeconds;
+
+            if (retiredAfter < 0.25 * releaseTime)
+            {
+                const auto* voice = engine.getVoiceForNote(57);
+                soundedInRelease = soundedInRelease && voice != nullptr && voice->getCurrentLevel() > 0.0f
+                                                    && buffer.getMagnitude(0, buffer.getNumSamples()) > 0.0f;
+            }
+        }
+        expect(soundedInRelease);
+        expect(engine.getVoiceForNote(57) == nullptr);
+        expectWithinAbsoluteError(retiredAfter, releaseTime, 0.25 * releaseTime + blockSeconds);
         // Add more DSP and thread safety tests here
     }
 };
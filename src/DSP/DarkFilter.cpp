@@ -1 +1,100 @@
-// ...existing code...
+#include "DarkFilter.h"
+#include <juce_dsp/juce_dsp.h>
+#include <cmath>
+
+namespace
+{
+    // Key tracking reference, middle C
+    constexpr float keyTrackingReference = 261.63f;
+}
+
+void DarkFilter::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    for (int lane = 0; lane < maxLanes; ++lane)
+    {
+        if (noteFrequencies[(size_t) lane] <= 0.0f)
+            noteFrequencies[(size_t) lane] = keyTrackingReference;
+        updateCutoffTarget(lane);
+    }
+
+    reset();
+}
+
+void DarkFilter::reset()
+{
+    cutoffs = cutoffTargets;
+    for (auto& stage : states)
+        stage.fill(0.0f);
+}
+
+void DarkFilter::setCutoffFrequency(float frequency)
+{
+    cutoffFrequency = frequency;
+    for (int lane = 0; lane < maxLanes; ++lane)
+        updateCutoffTarget(lane);
+}
+
+void DarkFilter::setResonance(float amount)
+{
+    feedback = 4.0f * juce::jlimit(0.0f, 1.0f, amount);
+}
+
+void DarkFilter::setKeyTracking(float amount)
+{
+    keyTracking = juce::jlimit(0.0f, 1.0f, amount);
+    for (int lane = 0; lane < maxLanes; ++lane)
+        updateCutoffTarget(lane);
+}
+
+void DarkFilter::setModulationDepth(float octaves)
+{
+    modulationDepth = octaves;
+}
+
+void DarkFilter::setNoteFrequency(int lane, float frequency)
+{
+    jassert(juce::isPositiveAndBelow(lane, maxLanes));
+    noteFrequencies[(size_t) lane] = juce::jmax(1.0f, frequency);
+    updateCutoffTarget(lane);
+}
+
+void DarkFilter::resetLane(int lane)
+{
+    jassert(juce::isPositiveAndBelow(lane, maxLanes));
+
+    cutoffs[(size_t) lane] = cutoffTargets[(size_t) lane];
+    for (auto& stage : states)
+        stage[(size_t) lane] = 0.0f;
+}
+
+void DarkFilter::processInterleaved(float* frames, int numSamples, const float* modulation)
+{
+    const auto& kernels = DspKernels::get();
+    const bool modulated = modulation != nullptr && modulationDepth != 0.0f;
+
+    for (int offset = 0; offset < numSamples; offset += controlInterval)
+    {
+        // Partly make up the passband loss of the feedback, 1 / (1 + feedback)
+        const DspKernels::LadderLanes lanes {
+            cutoffs.data(), cutoffTargets.data(), states[0].data(),
+            modulated ? modulation + offset * maxLanes : nullptr, modulationDepth,
+            feedback, 1.0f + 0.5f * feedback
+        };
+
+        kernels.ladderFrames(lanes, frames + offset * maxLanes, juce::jmin(controlInterval, numSamples - offset));
+    }
+
+    for (auto& stage : states)
+        for (auto& state : stage)
+            juce::dsp::util::snapToZero(state);
+}
+
+void DarkFilter::updateCutoffTarget(int lane)
+{
+    const float tracked = cutoffFrequency
+                        * std::pow(noteFrequencies[(size_t) lane] / keyTrackingReference, keyTracking);
+    const float limited = juce::jlimit(10.0f, (float) (sampleRate * 0.45), tracked);
+    cutoffTargets[(size_t) lane] = juce::MathConstants<float>::pi * limited / (float) sampleRate;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include "Kernels/DspKernels.h"
+
+/**
+ * DarkFilter - Zero-delay-feedback 4-pole ladder lowpass, up to 8 voices at once.
+ *
+ * Four TPT one-pole stages with the global feedback solved implicitly, so the
+ * cutoff stays accurate and sweeps cleanly up to the top of the band. The
+ * feedback path runs through a cheap rational soft clipper: the linear
+ * solution estimates the last stage's output, and the saturated estimate is
+ * fed back. High resonance then rings and self-oscillates without blowing
+ * up, and the dry signal stays clean.
+ *
+ * Lanes are voices, in the interleaved frames[i * maxLanes + lane] layout of
+ * the oscillator bank, so one call filters every voice in SIMD
+ * (DspKernels::ladderFrames). The cutoff is set once and spread per lane by
+ * key tracking from each voice's note. It glides to a new value across the
+ * next call, like StateVariableFilterBank. An optional modulation frame moves
+ * each lane's cutoff per sample, in octaves.
+ */
+class DarkFilter
+{
+public:
+    static constexpr int maxLanes = DspKernels::numLanes;
+    static constexpr int controlInterval = 32;
+
+    void prepare(double newSampleRate);
+    void reset();
+
+    // Shared by every lane; they glide there over the next process call
+    void setCutoffFrequency(float frequency);
+    void setResonance(float amount); // 0 - 1, self-oscillates at 1
+    void setKeyTracking(float amount); // 0 = fixed cutoff, 1 = cutoff follows the note 1:1
+    void setModulationDepth(float octaves); // Cutoff shift at a modulation value of 1
+
+    // Note the lane's key tracking follows, relative to middle C
+    void setNoteFrequency(int lane, float frequency);
+
+    // Clears one lane's integrators and jumps its cutoff to the target, e.g. for a new note
+    void resetLane(int lane);
+
+    // Filters all maxLanes lanes of interleaved frames in place. modulation holds frames of
+    // the same layout, scaled by the modulation depth; nullptr leaves the cutoff alone.
+    void processInterleaved(float* frames, int numSamples, const float* modulation = nullptr);
+
+private:
+    double sampleRate = 44100.0;
+
+    float cutoffFrequency = 2000.0f;
+    float keyTracking = 0.0f;
+    float feedback = 0.0f;
+    float modulationDepth = 0.0f;
+
+    // Normalised cutoff (pi * fc / fs) and its target per lane, four integrators per lane
+    alignas(32) std::array<float, maxLanes> cutoffs {};
+    alignas(32) std::array<float, maxLanes> cutoffTargets {};
+    alignas(32) std::array<std::array<float, maxLanes>, 4> states {};
+
+    std::array<float, maxLanes> noteFrequencies {};
+
+    void updateCutoffTarget(int lane);
+};
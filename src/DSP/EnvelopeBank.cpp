@@ -0,0 +1,192 @@
+#include "EnvelopeBank.h"
+#include "../Synth/SynthLayer.h"
+#include <cmath>
+
+namespace
+{
+    // How far past its end point each curve aims: the attack overshoots 1 by 30%,
+    // decay and release come within 0.01% of their targets
+    constexpr double attackTargetRatio = 0.3;
+    constexpr double decayTargetRatio = 1.0e-4;
+
+    // Per-sample coefficient that takes a one-pole from its start to within ratio
+    // of the target in numSamples
+    double getCoefficient(double numSamples, double ratio)
+    {
+        return std::exp(-std::log((1.0 + ratio) / ratio) / juce::jmax(1.0, numSamples));
+    }
+
+    // Samples the recurrence needs to take level past end, aiming at target
+    int getSegmentLength(double level, double end, double target, double coefficient)
+    {
+        const double samples = std::ceil(std::log((end - target) / (level - target)) / std::log(coefficient));
+        return (int) juce::jlimit(1.0, (double) std::numeric_limits<int>::max() - 1.0, samples);
+    }
+}
+
+void EnvelopeBank::prepare(double newSampleRate, int maxFrames)
+{
+    sampleRate = newSampleRate;
+    frames.assign((size_t) (juce::jmax(1, maxFrames) * maxLanes), 0.0f);
+    reset();
+}
+
+void EnvelopeBank::releaseResources()
+{
+    frames.clear();
+    frames.shrink_to_fit();
+}
+
+void EnvelopeBank::reset()
+{
+    for (int lane = 0; lane < maxLanes; ++lane)
+        enterStage(lane, Stage::idle);
+}
+
+void EnvelopeBank::setAttackTime(float seconds)
+{
+    attackTime = juce::jmax(0.0f, seconds);
+    updateStage(Stage::attack);
+}
+
+void EnvelopeBank::setDecayTime(float seconds)
+{
+    decayTime = juce::jmax(0.0f, seconds);
+    updateStage(Stage::decay);
+}
+
+void EnvelopeBank::setSustainLevel(float level)
+{
+    sustainLevel = juce::jlimit(0.0f, 1.0f, level);
+    updateStage(Stage::decay);
+}
+
+void EnvelopeBank::setReleaseTime(float seconds)
+{
+    releaseTime = juce::jmax(0.0f, seconds);
+    updateStage(Stage::release);
+}
+
+void EnvelopeBank::noteOn(int lane)
+{
+    jassert(juce::isPositiveAndBelow(lane, maxLanes));
+    enterStage(lane, Stage::attack);
+}
+
+void EnvelopeBank::noteOff(int lane)
+{
+    jassert(juce::isPositiveAndBelow(lane, maxLanes));
+    if (stages[(size_t) lane] != Stage::idle)
+        enterStage(lane, Stage::release);
+}
+
+void EnvelopeBank::stop(int lane)
+{
+    jassert(juce::isPositiveAndBelow(lane, maxLanes));
+    enterStage(lane, Stage::idle);
+}
+
+void EnvelopeBank::process(int startFrame, int numFrames)
+{
+    jassert(startFrame >= 0 && (size_t) ((startFrame + numFrames) * maxLanes) <= frames.size());
+
+    const auto& kernels = DspKernels::get();
+    float* output = frames.data() + startFrame * maxLanes;
+
+    // Run every lane up to the nearest segment end, then switch the lanes that got there
+    for (int done = 0; done < numFrames;)
+    {
+        int run = numFrames - done;
+        for (auto samples : remaining)
+            run = juce::jmin(run, samples);
+
+        kernels.envelopeFrames(levels.data(), coefficients.data(), offsets.data(), output + done * maxLanes, run);
+        done += run;
+
+        for (int lane = 0; lane < maxLanes; ++lane)
+        {
+            auto& samples = remaining[(size_t) lane];
+            if (samples == unbounded || (samples -= run) > 0)
+                continue;
+
+            if (stages[(size_t) lane] == Stage::attack)
+            {
+                levels[(size_t) lane] = 1.0f;
+                enterStage(lane, Stage::decay);
+            }
+            else
+            {
+                enterStage(lane, Stage::idle);
+            }
+        }
+    }
+}
+
+void EnvelopeBank::enterStage(int lane, Stage stage)
+{
+    const auto index = (size_t) lane;
+    const double level = levels[index];
+
+    stages[index] = stage;
+    remaining[index] = unbounded;
+
+    switch (stage)
+    {
+        case Stage::idle:
+            levels[index] = 0.0f;
+            coefficients[index] = 1.0f;
+            offsets[index] = 0.0f;
+            break;
+
+        case Stage::attack:
+        {
+            const double samples = attackTime * sampleRate;
+            if (samples < 1.0 || level >= 1.0)
+            {
+                levels[index] = 1.0f;
+                enterStage(lane, Stage::decay);
+                return;
+            }
+
+            const double target = 1.0 + attackTargetRatio;
+            const double coefficient = getCoefficient(samples, attackTargetRatio);
+            coefficients[index] = (float) coefficient;
+            offsets[index] = (float) (target * (1.0 - coefficient));
+            remaining[index] = getSegmentLength(level, 1.0, target, coefficient);
+            break;
+        }
+
+        case Stage::decay:
+        {
+            const double coefficient = getCoefficient(decayTime * sampleRate, decayTargetRatio);
+            coefficients[index] = (float) coefficient;
+            offsets[index] = (float) (sustainLevel * (1.0 - coefficient));
+            break;
+        }
+
+        case Stage::release:
+        {
+            constexpr double end = SynthLayer::silenceThreshold;
+            if (level <= end)
+            {
+                enterStage(lane, Stage::idle);
+                return;
+            }
+
+            // Aims just below zero, so a release from full level is silent after releaseTime
+            const double target = -decayTargetRatio;
+            const double coefficient = getCoefficient(releaseTime * sampleRate, decayTargetRatio);
+            coefficients[index] = (float) coefficient;
+            offsets[index] = (float) (target * (1.0 - coefficient));
+            remaining[index] = getSegmentLength(level, end, target, coefficient);
+            break;
+        }
+    }
+}
+
+void EnvelopeBank::updateStage(Stage stage)
+{
+    for (int lane = 0; lane < maxLanes; ++lane)
+        if (stages[(size_t) lane] == stage)
+            enterStage(lane, stage);
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include <limits>
+#include <vector>
+#include "Kernels/DspKernels.h"
+
+/**
+ * EnvelopeBank - ADSR envelopes for up to eight voices, advanced together.
+ *
+ * Lane v is the envelope of voice v in the matching OscillatorLayer bank.
+ * Every segment is an exponential approach to a target, computed by the
+ * one-pole recurrence level = level * coefficient + offset, so all lanes
+ * advance in one SIMD pass (DspKernels::envelopeFrames). The length of each
+ * lane's current segment is solved in closed form when the segment starts;
+ * process() runs the recurrence up to the next lane's segment end, switches
+ * that lane's coefficients and carries on. Stage changes stay sample-accurate
+ * without a per-sample branch.
+ *
+ * The attack aims past 1 so it arrives in attackTime with an analogue-style
+ * curve. The decay settles on the sustain level. The release falls from full
+ * level to silence (SynthLayer::silenceThreshold) in releaseTime, after which
+ * the lane is idle: isIdle() is how the engine learns a voice has finished.
+ *
+ * process() writes interleaved frames[i * maxLanes + lane] into the bank's
+ * own buffer, where the oscillator bank and the voices' layers read them.
+ */
+class EnvelopeBank
+{
+public:
+    static constexpr int maxLanes = DspKernels::numLanes;
+
+    enum class Stage
+    {
+        idle,
+        attack,
+        decay, // Also the sustain - the decay converges on the sustain level
+        release
+    };
+
+    // maxFrames is the most process() is asked to keep at once
+    void prepare(double newSampleRate, int maxFrames);
+    void releaseResources();
+    void reset();
+
+    // Shared by every lane; a lane in the affected stage picks the change up immediately
+    void setAttackTime(float seconds);
+    void setDecayTime(float seconds);
+    void setSustainLevel(float level);
+    void setReleaseTime(float seconds);
+
+    // Lane lifecycle - a retrigger attacks from the current level, so it never clicks
+    void noteOn(int lane);
+    void noteOff(int lane);
+    void stop(int lane); // Silences the lane immediately
+
+    Stage getStage(int lane) const { return stages[(size_t) lane]; }
+    bool isIdle(int lane) const { return stages[(size_t) lane] == Stage::idle; }
+
+    // Advances every lane by numFrames, storing them from startFrame on
+    void process(int startFrame, int numFrames);
+
+    // Frames stored by process(), frames[i * maxLanes + lane] from startFrame
+    const float* getFrames(int startFrame) const { return frames.data() + startFrame * maxLanes; }
+
+private:
+    double sampleRate = 44100.0;
+
+    float attackTime = 0.1f;
+    float decayTime = 0.5f;
+    float sustainLevel = 1.0f;
+    float releaseTime = 1.0f;
+
+    // Per-lane recurrence state, and the samples left before each lane's next stage
+    alignas(32) std::array<float, maxLanes> levels {};
+    alignas(32) std::array<float, maxLanes> coefficients {};
+    alignas(32) std::array<float, maxLanes> offsets {};
+    std::array<int, maxLanes> remaining {};
+    std::array<Stage, maxLanes> stages {};
+
+    std::vector<float> frames;
+
+    // Sets the lane's coefficients and segment length for stage, from its current level
+    void enterStage(int lane, Stage stage);
+
+    // Re-solves every lane in stage after a parameter change
+    void updateStage(Stage stage);
+
+    static constexpr int unbounded = std::numeric_limits<int>::max(); // No stage change ahead
+};
@@ -0,0 +1,512 @@
+#include "ConvolutionReverb.h"
+#include "../Kernels/DspKernels.h"
+#include <cmath>
+
+namespace
+{
+    constexpr int headOrder = 7; // FFTs of twice the partition size
+    constexpr int tailOrder = 11;
+    constexpr int headBins = ConvolutionReverb::headSize + 1;
+    constexpr int tailBins = ConvolutionReverb::tailSize + 1;
+    constexpr int headStride = 72; // Bins rounded up to whole vectors; the padding stays zero
+    constexpr int tailStride = 1032;
+    constexpr int maxHeadPartitions = (2 * ConvolutionReverb::tailSize - ConvolutionReverb::headSize) / ConvolutionReverb::headSize;
+    constexpr int numSlots = 4; // Tail blocks in flight: being written, computed, read, and one spare
+    constexpr float responseLevel = 0.5f; // RMS gain for white noise, like the algorithmic reverb
+
+    // The FFT's interleaved bins to split spectra (real parts, then imaginary parts) and back
+    void splitBins(const float* interleaved, float* split, int numBins, int stride)
+    {
+        for (int k = 0; k < numBins; ++k)
+        {
+            split[k] = interleaved[2 * k];
+            split[stride + k] = interleaved[2 * k + 1];
+        }
+    }
+
+    void joinBins(const float* split, float* interleaved, int numBins, int stride)
+    {
+        for (int k = 0; k < numBins; ++k)
+        {
+            interleaved[2 * k] = split[k];
+            interleaved[2 * k + 1] = split[stride + k];
+        }
+    }
+
+    // Spectra of consecutive blockSize segments of response, from offset on, zero-padded to twice the block
+    std::vector<float> partitionSpectra(const juce::dsp::FFT& fft, const float* response, int length,
+                                        int offset, int blockSize, int numPartitions, int numBins, int stride)
+    {
+        std::vector<float> spectra((size_t) (numPartitions * 2 * stride), 0.0f);
+        std::vector<float> buffer((size_t) (4 * blockSize));
+
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+            const int start = offset + p * blockSize;
+            const int count = juce::jmin(blockSize, length - start);
+            std::copy(response + start, response + start + count, buffer.begin());
+
+            fft.performRealOnlyForwardTransform(buffer.data(), true);
+            splitBins(buffer.data(), spectra.data() + p * 2 * stride, numBins, stride);
+        }
+
+        return spectra;
+    }
+}
+
+//==============================================================================
+struct ConvolutionReverb::Engine
+{
+    int length = 0;
+    int headPartitions = 0;
+    int tailPartitions = 0;
+
+    // Immutable once built
+    std::array<std::array<float, headSize>, 2> directTaps {}; // Reversed, so the FIR reads forwards
+    std::array<std::vector<float>, 2> headSpectra;
+    std::array<std::vector<float>, 2> tailSpectra;
+
+    // Audio thread to worker: tailSize samples per side per slot, left then right
+    std::array<std::vector<float>, numSlots> tailInputs;
+    std::array<std::vector<float>, numSlots> tailOutputs;
+    std::atomic<int> submitted { 0 }; // Blocks the audio thread has handed over
+    std::atomic<int> done { 0 }; // Blocks the worker has finished
+    std::atomic<int> firstValidBlock { 0 }; // Set by a reset; earlier blocks are discarded
+    std::atomic<bool> clearRequested { false };
+
+    // Worker only
+    juce::dsp::FFT fft { tailOrder };
+    std::array<std::vector<float>, 2> tailWindow; // The previous input block per side
+    std::array<std::vector<float>, 2> tailHistory;
+    std::vector<float> buffer;
+    std::vector<float> accumulator;
+    int slot = 0;
+};
+
+class ConvolutionReverb::TailWorker : public juce::Thread
+{
+public:
+    explicit TailWorker(ConvolutionReverb& owner)
+        : juce::Thread("Convolution Tail"),
+          reverb(owner)
+    {
+    }
+
+    void run() override
+    {
+        juce::ScopedNoDenormals noDenormals;
+        reverb.runTail();
+    }
+
+    juce::WaitableEvent blockFinished;
+
+private:
+    ConvolutionReverb& reverb;
+};
+
+//==============================================================================
+ConvolutionReverb::ConvolutionReverb()
+    : worker(std::make_unique<TailWorker>(*this)),
+      headFFT(headOrder)
+{
+}
+
+ConvolutionReverb::~ConvolutionReverb()
+{
+    worker->stopThread(2000);
+
+    delete engine;
+    delete pendingEngine.exchange(nullptr);
+    delete retiredEngine.exchange(nullptr);
+}
+
+void ConvolutionReverb::prepare(double newSampleRate)
+{
+    const juce::CriticalSection::ScopedLockType lock(buildLock);
+
+    // Nothing else touches the engines while the audio thread is stopped and the worker is too
+    worker->stopThread(2000);
+
+    delete engine;
+    delete pendingEngine.exchange(nullptr);
+    delete retiredEngine.exchange(nullptr);
+    engine = nullptr;
+
+    sampleRate = newSampleRate;
+
+    // A quarter of the worker's deadline, which is one tail block
+    pollIntervalMs = juce::jmax(1, (int) (250.0 * tailSize / sampleRate));
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        headWindow[(size_t) ch].assign((size_t) (2 * headSize), 0.0f);
+        headHistory[(size_t) ch].assign((size_t) (maxHeadPartitions * 2 * headStride), 0.0f);
+        headOutput[(size_t) ch].assign((size_t) headSize, 0.0f);
+    }
+    headBuffer.assign((size_t) (4 * headSize), 0.0f);
+    headAccumulator.assign((size_t) (2 * headStride), 0.0f);
+
+    if (source.getNumSamples() > 0)
+        engine = createEngine().release();
+
+    responseLength.store(engine != nullptr ? engine->length : 0);
+    workerEngine.store(engine, std::memory_order_release);
+
+    tailBlock = 0;
+    reset();
+
+    // No response, no worker: setImpulseResponse() starts it with the first one
+    if (engine != nullptr)
+        worker->startThread(juce::Thread::Priority::high);
+}
+
+void ConvolutionReverb::reset()
+{
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        std::fill(headWindow[(size_t) ch].begin(), headWindow[(size_t) ch].end(), 0.0f);
+        std::fill(headHistory[(size_t) ch].begin(), headHistory[(size_t) ch].end(), 0.0f);
+        std::fill(headOutput[(size_t) ch].begin(), headOutput[(size_t) ch].end(), 0.0f);
+    }
+
+    headPosition = 0;
+    headSlot = 0;
+    tailPosition = 0;
+    tailReady = false;
+
+    // The tail history belongs to the worker, which clears it before the next block
+    if (engine != nullptr)
+    {
+        engine->firstValidBlock.store(tailBlock, std::memory_order_relaxed);
+        engine->clearRequested.store(true, std::memory_order_release);
+    }
+}
+
+void ConvolutionReverb::setImpulseResponse(const juce::AudioBuffer<float>& response, double responseSampleRate)
+{
+    if (response.getNumChannels() == 0 || response.getNumSamples() == 0 || responseSampleRate <= 0.0)
+        return;
+
+    const juce::CriticalSection::ScopedLockType lock(buildLock);
+
+    const int maxLength = (int) std::ceil(maxImpulseSeconds * responseSampleRate);
+    source.setSize(juce::jmin(2, response.getNumChannels()), juce::jmin(response.getNumSamples(), maxLength));
+    for (int ch = 0; ch < source.getNumChannels(); ++ch)
+        source.copyFrom(ch, 0, response, ch, 0, source.getNumSamples());
+    sourceSampleRate = responseSampleRate;
+
+    // Not prepared yet: prepare() builds it
+    if (sampleRate <= 0.0)
+        return;
+
+    auto created = createEngine();
+    responseLength.store(created->length);
+
+    // A response the audio thread never picked up is still ours to free
+    delete pendingEngine.exchange(created.release(), std::memory_order_acq_rel);
+
+    if (! worker->isThreadRunning())
+        worker->startThread(juce::Thread::Priority::high);
+}
+
+void ConvolutionReverb::process(float* left, float* right, int numSamples)
+{
+    takePendingEngine();
+
+    if (engine == nullptr)
+    {
+        juce::FloatVectorOperations::clear(left, numSamples);
+        juce::FloatVectorOperations::clear(right, numSamples);
+        return;
+    }
+
+    const auto& kernels = DspKernels::get();
+    float* const channels[] { left, right };
+
+    for (int offset = 0; offset < numSamples;)
+    {
+        if (tailPosition == 0)
+            beginTailWindow();
+
+        // Runs end on head block boundaries, which tail block boundaries fall on too
+        const int n = juce::jmin(numSamples - offset, headSize - headPosition);
+        float* tailInput = engine->tailInputs[(size_t) (tailBlock % numSlots)].data() + tailPosition;
+        const float* tailOutput = engine->tailOutputs[(size_t) ((tailBlock + numSlots - 2) % numSlots)].data() + tailPosition;
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            float* samples = channels[ch] + offset;
+            float* window = headWindow[(size_t) ch].data() + headSize + headPosition;
+
+            juce::FloatVectorOperations::copy(window, samples, n);
+            juce::FloatVectorOperations::copy(tailInput + ch * tailSize, samples, n);
+
+            // Direct FIR over the last headSize inputs, then the two partitioned tiers
+            kernels.convolveDirect(engine->directTaps[(size_t) ch].data(), headSize, window - (headSize - 1), samples, n);
+            juce::FloatVectorOperations::add(samples, headOutput[(size_t) ch].data() + headPosition, n);
+            if (tailReady)
+                juce::FloatVectorOperations::add(samples, tailOutput + ch * tailSize, n);
+        }
+
+        offset += n;
+        headPosition += n;
+        tailPosition += n;
+
+        if (headPosition == headSize)
+        {
+            processHead();
+            headPosition = 0;
+        }
+
+        if (tailPosition == tailSize)
+        {
+            if (engine->tailPartitions > 0)
+            {
+                engine->submitted.store(tailBlock + 1, std::memory_order_release);
+
+                // In realtime the worker polls, so the audio thread never takes the event's lock.
+                // Offline the audio thread is about to wait for it anyway.
+                if (waitForTail)
+                    worker->notify();
+            }
+
+            ++tailBlock;
+            tailPosition = 0;
+        }
+    }
+}
+
+double ConvolutionReverb::getTailLengthSeconds() const
+{
+    return sampleRate > 0.0 ? (double) responseLength.load() / sampleRate : 0.0;
+}
+
+void ConvolutionReverb::takePendingEngine()
+{
+    // One engine in retirement at a time: the worker frees it within a poll interval
+    if (pendingEngine.load(std::memory_order_relaxed) == nullptr || retiredEngine.load(std::memory_order_acquire) != nullptr)
+        return;
+
+    Engine* next = pendingEngine.exchange(nullptr, std::memory_order_acq_rel);
+    if (next == nullptr)
+        return;
+
+    retiredEngine.store(engine, std::memory_order_release);
+    engine = next;
+    workerEngine.store(next, std::memory_order_release);
+
+    tailBlock = 0;
+    reset();
+}
+
+void ConvolutionReverb::processHead()
+{
+    const auto& kernels = DspKernels::get();
+    const int partitions = engine->headPartitions;
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        float* window = headWindow[(size_t) ch].data();
+
+        if (partitions > 0)
+        {
+            // Overlap-save: the transform of the last two blocks, against every partition's past input
+            float* history = headHistory[(size_t) ch].data();
+            juce::FloatVectorOperations::copy(headBuffer.data(), window, 2 * headSize);
+            headFFT.performRealOnlyForwardTransform(headBuffer.data(), true);
+            splitBins(headBuffer.data(), history + headSlot * 2 * headStride, headBins, headStride);
+
+            std::fill(headAccumulator.begin(), headAccumulator.end(), 0.0f);
+            for (int p = 0; p < partitions; ++p)
+            {
+                const int slot = (headSlot - p + partitions) % partitions;
+                kernels.multiplyAddSpectra(headAccumulator.data(), history + slot * 2 * headStride,
+                                           engine->headSpectra[(size_t) ch].data() + p * 2 * headStride, headStride);
+            }
+
+            joinBins(headAccumulator.data(), headBuffer.data(), headBins, headStride);
+            headFFT.performRealOnlyInverseTransform(headBuffer.data());
+            juce::FloatVectorOperations::copy(headOutput[(size_t) ch].data(), headBuffer.data() + headSize, headSize);
+        }
+
+        // The current block becomes the previous one
+        juce::FloatVectorOperations::copy(window, window + headSize, headSize);
+    }
+
+    if (partitions > 0)
+        headSlot = (headSlot + 1) % partitions;
+}
+
+void ConvolutionReverb::beginTailWindow()
+{
+    // This window plays the tail of the block submitted two windows ago
+    const int due = tailBlock - 2;
+    tailReady = false;
+
+    if (engine->tailPartitions == 0 || due < engine->firstValidBlock.load(std::memory_order_relaxed))
+        return;
+
+    if (waitForTail)
+        while (engine->done.load(std::memory_order_acquire) <= due && worker->isThreadRunning())
+            worker->blockFinished.wait(1);
+
+    tailReady = engine->done.load(std::memory_order_acquire) > due;
+}
+
+void ConvolutionReverb::runTail()
+{
+    while (! worker->threadShouldExit())
+    {
+        // Engines the audio thread has dropped are freed here, never on the audio thread
+        delete retiredEngine.exchange(nullptr, std::memory_order_acq_rel);
+
+        if (auto* tailEngine = workerEngine.load(std::memory_order_acquire))
+            while (processTailBlock(*tailEngine))
+                worker->blockFinished.signal();
+
+        worker->wait(pollIntervalMs);
+    }
+}
+
+bool ConvolutionReverb::processTailBlock(Engine& tailEngine)
+{
+    auto& e = tailEngine;
+
+    if (e.clearRequested.exchange(false, std::memory_order_acq_rel))
+    {
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            std::fill(e.tailWindow[(size_t) ch].begin(), e.tailWindow[(size_t) ch].end(), 0.0f);
+            std::fill(e.tailHistory[(size_t) ch].begin(), e.tailHistory[(size_t) ch].end(), 0.0f);
+        }
+        e.slot = 0;
+        e.done.store(e.firstValidBlock.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+
+    const int block = e.done.load(std::memory_order_relaxed);
+    if (block >= e.submitted.load(std::memory_order_acquire))
+        return false;
+
+    const auto& kernels = DspKernels::get();
+    const int partitions = e.tailPartitions;
+    const float* input = e.tailInputs[(size_t) (block % numSlots)].data();
+    float* output = e.tailOutputs[(size_t) (block % numSlots)].data();
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        float* window = e.tailWindow[(size_t) ch].data();
+        float* history = e.tailHistory[(size_t) ch].data();
+        const float* samples = input + ch * tailSize;
+
+        // Same overlap-save scheme as the head, in blocks of tailSize
+        std::copy(window, window + tailSize, e.buffer.begin());
+        std::copy(samples, samples + tailSize, e.buffer.begin() + tailSize);
+        std::copy(samples, samples + tailSize, window);
+
+        e.fft.performRealOnlyForwardTransform(e.buffer.data(), true);
+        splitBins(e.buffer.data(), history + e.slot * 2 * tailStride, tailBins, tailStride);
+
+        std::fill(e.accumulator.begin(), e.accumulator.end(), 0.0f);
+        for (int p = 0; p < partitions; ++p)
+        {
+            const int slot = (e.slot - p + partitions) % partitions;
+            kernels.multiplyAddSpectra(e.accumulator.data(), history + slot * 2 * tailStride,
+                                       e.tailSpectra[(size_t) ch].data() + p * 2 * tailStride, tailStride);
+        }
+
+        joinBins(e.accumulator.data(), e.buffer.data(), tailBins, tailStride);
+        e.fft.performRealOnlyInverseTransform(e.buffer.data());
+        std::copy(e.buffer.begin() + tailSize, e.buffer.begin() + 2 * tailSize, output + ch * tailSize);
+    }
+
+    e.slot = (e.slot + 1) % partitions;
+    e.done.store(block + 1, std::memory_order_release);
+    return true;
+}
+
+std::unique_ptr<ConvolutionReverb::Engine> ConvolutionReverb::createEngine() const
+{
+    const int sourceLength = source.getNumSamples();
+    const double speed = sourceSampleRate / sampleRate;
+    const int maxLength = (int) std::ceil(maxImpulseSeconds * sampleRate);
+    int length = juce::jlimit(1, maxLength, (int) std::ceil(sourceLength / speed));
+
+    // Resampled to the engine rate; lowpassed first when that loses bandwidth
+    juce::AudioBuffer<float> response(2, length);
+    std::vector<float> padded((size_t) sourceLength + 8, 0.0f);
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        const float* input = source.getReadPointer(juce::jmin(ch, source.getNumChannels() - 1));
+        std::copy(input, input + sourceLength, padded.begin());
+
+        if (speed > 1.0)
+        {
+            for (int pass = 0; pass < 2; ++pass)
+            {
+                juce::IIRFilter lowpass;
+                lowpass.setCoefficients(juce::IIRCoefficients::makeLowPass(sourceSampleRate, 0.45 * sampleRate));
+                lowpass.processSamples(padded.data(), sourceLength);
+            }
+        }
+
+        if (speed == 1.0)
+        {
+            response.copyFrom(ch, 0, padded.data(), length);
+        }
+        else
+        {
+            juce::LagrangeInterpolator interpolator;
+            interpolator.process(speed, padded.data(), response.getWritePointer(ch), length);
+        }
+    }
+
+    // Trim the silence after the response has decayed by 90 dB
+    const float floor = response.getMagnitude(0, length) * 3.0e-5f;
+    while (length > 1 && std::abs(response.getSample(0, length - 1)) <= floor && std::abs(response.getSample(1, length - 1)) <= floor)
+        --length;
+
+    // Normalised so the louder side has the same energy whatever the response
+    double energy = 0.0;
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        double sideEnergy = 0.0;
+        for (const float* h = response.getReadPointer(ch), * end = h + length; h < end; ++h)
+            sideEnergy += (double) *h * *h;
+        energy = juce::jmax(energy, sideEnergy);
+    }
+    response.applyGain(0, length, energy > 0.0 ? responseLevel / (float) std::sqrt(energy) : 0.0f);
+
+    auto created = std::make_unique<Engine>();
+    created->length = length;
+    created->headPartitions = juce::jlimit(0, maxHeadPartitions, (juce::jmin(length, 2 * tailSize) - headSize + headSize - 1) / headSize);
+    created->tailPartitions = juce::jmax(0, (length - 2 * tailSize + tailSize - 1) / tailSize);
+
+    const juce::dsp::FFT headTransform(headOrder);
+    const juce::dsp::FFT tailTransform(tailOrder);
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        const float* h = response.getReadPointer(ch);
+
+        for (int t = 0; t < juce::jmin(length, headSize); ++t)
+            created->directTaps[(size_t) ch][(size_t) (headSize - 1 - t)] = h[t];
+
+        created->headSpectra[(size_t) ch] = partitionSpectra(headTransform, h, length, headSize, headSize,
+                                                             created->headPartitions, headBins, headStride);
+        created->tailSpectra[(size_t) ch] = partitionSpectra(tailTransform, h, length, 2 * tailSize, tailSize,
+                                                             created->tailPartitions, tailBins, tailStride);
+
+        created->tailWindow[(size_t) ch].assign((size_t) tailSize, 0.0f);
+        created->tailHistory[(size_t) ch].assign((size_t) (created->tailPartitions * 2 * tailStride), 0.0f);
+    }
+
+    for (int s = 0; s < numSlots; ++s)
+    {
+        created->tailInputs[(size_t) s].assign((size_t) (2 * tailSize), 0.0f);
+        created->tailOutputs[(size_t) s].assign((size_t) (2 * tailSize), 0.0f);
+    }
+
+    created->buffer.assign((size_t) (4 * tailSize), 0.0f);
+    created->accumulator.assign((size_t) (2 * tailStride), 0.0f);
+    return created;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * ConvolutionReverb - Zero-latency stereo convolution with a loaded impulse response.
+ *
+ * The response is split into three tiers of non-uniform partitions, so the
+ * cost of a long response never lands on the audio thread:
+ *  - the first headSize taps run as a direct FIR, sample by sample
+ *  - taps up to 2 * tailSize are uniformly partitioned FFT convolution in
+ *    blocks of headSize, on the audio thread
+ *  - everything after that is partitioned in blocks of tailSize and computed
+ *    on a background thread, one block behind: a block of input submitted at
+ *    time t is only needed from t + tailSize on, which is the worker's deadline
+ *
+ * The worker polls for submitted blocks four times per deadline instead of
+ * being woken, so rendering in realtime never takes a lock. It only runs
+ * once a response is loaded.
+ *
+ * Responses are resampled and partitioned off the audio thread into an
+ * Engine, which the audio thread picks up at the start of a block without
+ * locking. prepare() and setImpulseResponse() may run on different threads,
+ * e.g. the message thread and a loader; they serialise on buildLock. Engines the audio thread lets go of are freed by the worker. If the
+ * worker misses a deadline, that block of the tail is dropped rather than
+ * waited for, except when rendering offline (setWaitForTail).
+ *
+ * A mono response is used for both sides; a stereo one convolves left with
+ * left and right with right. Responses are normalised to the same energy, so
+ * switching between them keeps the level.
+ */
+class ConvolutionReverb
+{
+public:
+    static constexpr int headSize = 64;
+    static constexpr int tailSize = 1024;
+    static constexpr double maxImpulseSeconds = 10.0;
+
+    ConvolutionReverb();
+    ~ConvolutionReverb();
+
+    // Rebuilds the loaded response for the sample rate and starts the tail worker (never the audio thread)
+    void prepare(double newSampleRate);
+
+    // Clears the signal history; cheap enough for the audio thread
+    void reset();
+
+    // Resamples and partitions a response on the calling thread - never the audio thread,
+    // and best a background one, since a long response takes a while. Takes effect at
+    // the start of the next process() call.
+    void setImpulseResponse(const juce::AudioBuffer<float>& response, double responseSampleRate);
+
+    // Offline rendering waits for late tail blocks instead of dropping them
+    void setWaitForTail(bool shouldWait) { waitForTail = shouldWait; }
+
+    // Replaces left and right with the convolved signal; silence until a response is loaded
+    void process(float* left, float* right, int numSamples);
+
+    double getTailLengthSeconds() const;
+
+private:
+    struct Engine;
+    class TailWorker;
+
+    double sampleRate = 0.0;
+    bool waitForTail = false;
+    int pollIntervalMs = 5; // How often the worker looks for submitted tail blocks
+
+    // The response as loaded, kept to rebuild it for a new sample rate
+    juce::CriticalSection buildLock; // Held by prepare() and setImpulseResponse(), never by the audio thread
+    juce::AudioBuffer<float> source;
+    double sourceSampleRate = 0.0;
+    std::atomic<int> responseLength { 0 }; // In samples at sampleRate
+
+    Engine* engine = nullptr; // Audio thread's current engine
+    std::atomic<Engine*> pendingEngine { nullptr }; // Built, not yet picked up
+    std::atomic<Engine*> workerEngine { nullptr }; // The engine the worker computes tails for
+    std::atomic<Engine*> retiredEngine { nullptr }; // Dropped by the audio thread, freed by the worker
+    std::unique_ptr<TailWorker> worker;
+
+    // Head: a window of the previous and the current headSize inputs per side, the
+    // frequency-domain delay line of past input blocks and the next block of output
+    juce::dsp::FFT headFFT;
+    std::array<std::vector<float>, 2> headWindow;
+    std::array<std::vector<float>, 2> headHistory;
+    std::array<std::vector<float>, 2> headOutput;
+    std::vector<float> headBuffer; // FFT workspace
+    std::vector<float> headAccumulator;
+    int headPosition = 0; // Samples into the current head block
+    int headSlot = 0; // Delay-line slot of the current head block
+
+    // Tail hand-off: blocks of tailSize are numbered from the engine's start
+    int tailBlock = 0;
+    int tailPosition = 0;
+    bool tailReady = false; // Whether the block due in this window was finished in time
+
+    void takePendingEngine();
+    void processHead();
+    void beginTailWindow();
+
+    void runTail();
+    bool processTailBlock(Engine& tailEngine);
+
+    std::unique_ptr<Engine> createEngine() const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionReverb)
+};
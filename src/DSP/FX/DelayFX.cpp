@@ -0,0 +1,109 @@
+#include "DelayFX.h"
+#include <cmath>
+
+namespace
+{
+    constexpr double wowRate = 0.6; // Hz
+    constexpr double flutterRate = 7.0;
+    constexpr double wowSeconds = 0.0015; // Delay swing at full wow: about 10 cents of drift
+    constexpr double flutterSeconds = 0.00006;
+    constexpr double glideSeconds = 0.12;
+
+    // Repeats lose their top end: tape darker than the cleaner ping-pong
+    constexpr std::array<double, 2> toneCutoffs { 5500.0, 11000.0 };
+}
+
+void DelayFX::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    const double maxSwing = (wowSeconds + flutterSeconds) * sampleRate;
+    minimumDelay = (float) (DspKernels::delayChunk + 2 + std::ceil(maxSwing));
+    maximumDelay = (float) (maxDelaySeconds * sampleRate);
+
+    // Room for the longest delay, its swing and the cubic's extra sample
+    const int length = juce::nextPowerOfTwo((int) std::ceil(maximumDelay + maxSwing) + 4);
+    memoryLeft.assign((size_t) length, 0.0f);
+    memoryRight.assign((size_t) length, 0.0f);
+    mask = length - 1;
+
+    glideSamples = (float) (glideSeconds * sampleRate);
+    wowIncrement = (float) (wowRate / sampleRate);
+    flutterIncrement = (float) (flutterRate / sampleRate);
+
+    targetDelay = juce::jlimit(minimumDelay, maximumDelay, targetDelay);
+    setMode(mode); // The tone filter depends on the sample rate
+    updateModulation();
+    reset();
+}
+
+void DelayFX::reset()
+{
+    std::fill(memoryLeft.begin(), memoryLeft.end(), 0.0f);
+    std::fill(memoryRight.begin(), memoryRight.end(), 0.0f);
+    position = 0;
+    toneStates.fill(0.0f);
+    wowPhase = 0.0f;
+    flutterPhase = 0.0f;
+    delay = targetDelay;
+}
+
+void DelayFX::setDelayTime(double seconds)
+{
+    targetDelay = juce::jlimit(minimumDelay, maximumDelay, (float) (seconds * sampleRate));
+}
+
+void DelayFX::setMode(int newMode)
+{
+    mode = juce::jlimit((int) tape, (int) pingPong, newMode);
+    crossfeed = (float) mode;
+
+    const double cutoff = juce::jmin(toneCutoffs[(size_t) mode], 0.45 * sampleRate);
+    toneCoefficient = (float) (1.0 - std::exp(-juce::MathConstants<double>::twoPi * cutoff / sampleRate));
+}
+
+void DelayFX::setWow(float amount)
+{
+    wow = juce::jlimit(0.0f, 1.0f, amount);
+    updateModulation();
+}
+
+void DelayFX::process(float* left, float* right, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    // Exponential glide to the target, as a linear ramp across the call
+    const float glide = 1.0f - std::exp(-(float) numSamples / glideSamples);
+    const float endDelay = delay + (targetDelay - delay) * glide;
+
+    const DspKernels::DelayLines lines {
+        memoryLeft.data(), memoryRight.data(), mask, &position,
+        delay, (endDelay - delay) / (float) numSamples,
+        &wowPhase, wowIncrement, wowDepth,
+        &flutterPhase, flutterIncrement, flutterDepth,
+        toneStates.data(), toneCoefficient,
+        feedback, crossfeed
+    };
+
+    DspKernels::get().delayFrames(lines, left, right, numSamples);
+    delay = endDelay;
+}
+
+double DelayFX::getTailLengthSeconds() const
+{
+    const double seconds = targetDelay / sampleRate;
+    if (feedback <= 1.0e-3f)
+        return seconds;
+
+    // The soft clip only ever lowers the gain, so feedback bounds the decay per repeat
+    const double repeats = std::log(1.0e-6) / std::log(juce::jmin((double) feedback, 0.999));
+    return juce::jmin(seconds * (1.0 + repeats), 60.0);
+}
+
+void DelayFX::updateModulation()
+{
+    // Swings around the base delay, which minimumDelay keeps far enough from the writes
+    wowDepth = (float) (wow * wowSeconds * sampleRate);
+    flutterDepth = (float) (wow * flutterSeconds * sampleRate);
+}
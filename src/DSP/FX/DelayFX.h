@@ -1,9 +1,80 @@
 #pragma once
 #include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <vector>
+#include "../Kernels/DspKernels.h"
+
+/**
+ * DelayFX - Stereo tape and ping-pong delay.
+ *
+ * Each side is a power-of-two ring buffer sized in prepare() for the longest
+ * delay plus the modulation swing, read with Catmull-Rom cubic interpolation.
+ * Wow (a slow drift) and flutter (a faster wobble) modulate the read point
+ * together from one amount. Every repeat passes through a one-pole lowpass
+ * and a soft clip on the way back in, so repeats darken and feedback at or
+ * near one saturates instead of running away.
+ *
+ * Tape mode feeds each side back into itself. Ping-pong feeds the input to the
+ * left only and swaps the sides every repeat. A new delay time glides there
+ * like a tape machine changing speed, which bends the pitch of the repeats
+ * instead of clicking. The loop is DspKernels::delayFrames, which reads a
+ * whole chunk before writing it, so the delay never drops below one chunk.
+ */
 class DelayFX {
 public:
-    void process(float* data, int numSamples) {
-        // Simple placeholder: pass-through
-        // TODO: Implement delay buffer
-    }
+    static constexpr double maxDelaySeconds = 2.5;
+
+    // Matches the "delayMode" parameter choices
+    enum Mode
+    {
+        tape = 0,
+        pingPong
+    };
+
+    // Allocates the ring buffers for maxDelaySeconds (message thread)
+    void prepare(double newSampleRate);
+
+    // Clears the buffers and jumps to the target delay time
+    void reset();
+
+    void setDelayTime(double seconds);
+    void setFeedback(float amount) { feedback = juce::jlimit(0.0f, 1.0f, amount); }
+    void setMode(int newMode);
+    void setWow(float amount); // 0 - 1
+
+    // Replaces left and right with the delayed signal
+    void process(float* left, float* right, int numSamples);
+
+    // Time for the repeats to fall by 120 dB, capped for feedback near one
+    double getTailLengthSeconds() const;
+
+private:
+    double sampleRate = 44100.0;
+
+    std::vector<float> memoryLeft;
+    std::vector<float> memoryRight;
+    int mask = 0;
+    int position = 0;
+
+    float delay = 1000.0f; // Current delay in samples, gliding towards targetDelay
+    float targetDelay = 1000.0f;
+    float minimumDelay = 64.0f; // Kernel chunk plus the modulation swing
+    float maximumDelay = 1000.0f;
+    float glideSamples = 4096.0f; // Time constant of the glide
+
+    float feedback = 0.4f;
+    int mode = tape;
+    float crossfeed = 0.0f; // The mode as the kernel's pingPong blend
+    float toneCoefficient = 1.0f;
+    std::array<float, 2> toneStates {};
+
+    float wowPhase = 0.0f;
+    float flutterPhase = 0.0f;
+    float wowIncrement = 0.0f;
+    float flutterIncrement = 0.0f;
+    float wowDepth = 0.0f;
+    float flutterDepth = 0.0f;
+    float wow = 0.2f;
+
+    void updateModulation();
 };
@@ -0,0 +1,43 @@
+#include "DistortionFX.h"
+#include "../Kernels/DspKernels.h"
+
+void DistortionFX::reset()
+{
+    drive = targetDrive;
+    for (auto& channel : history)
+        channel.fill(0.0);
+}
+
+void DistortionFX::process(juce::dsp::AudioBlock<float>& block)
+{
+    const int numSamples = (int) block.getNumSamples();
+    if (numSamples == 0)
+        return;
+
+    const auto& kernels = DspKernels::get();
+    const int numChannels = juce::jmin((int) block.getNumChannels(), maxChannels);
+
+    const float startGain = 1.0f + drive;
+    const float endGain = 1.0f + targetDrive;
+    const float startLevel = getLevel(startGain);
+    const float scale = 1.0f / (float) numSamples;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const DspKernels::ShaperChannel channel {
+            history[(size_t) ch].data(), shape, order,
+            startGain, (endGain - startGain) * scale,
+            startLevel, (getLevel(endGain) - startLevel) * scale
+        };
+
+        kernels.shaperSamples(channel, block.getChannelPointer((size_t) ch), numSamples);
+    }
+
+    drive = targetDrive;
+}
+
+float DistortionFX::getLevel(float gain) const
+{
+    // Clip and fold already cap at 1
+    return shape == tanh ? 1.0f / std::tanh(gain) : 1.0f;
+}
@@ -0,0 +1,287 @@
+#include "EffectChain.h"
+#include "../../Synth/SynthLayer.h"
+
+namespace
+{
+    // "delaySync" choices in beats; 0 = free, set by "delayTime"
+    constexpr std::array<double, 6> syncBeats { 0.0, 1.0, 0.5, 0.75, 1.0 / 3.0, 0.25 };
+}
+
+EffectChain::EffectChain(juce::AudioProcessorValueTreeState& apvts, SmootherBank& smootherBank)
+    : smoothers(smootherBank)
+{
+    distortionDriveIndex = smoothers.getIndex("distortion");
+    distortionMixIndex = smoothers.getIndex("distortionMix");
+    delayTimeIndex = smoothers.getIndex("delayTime");
+    delayFeedbackIndex = smoothers.getIndex("delayFeedback");
+    delayMixIndex = smoothers.getIndex("delayMix");
+    delayWowIndex = smoothers.getIndex("delayWow");
+    reverbSizeIndex = smoothers.getIndex("reverbSize");
+    reverbDampIndex = smoothers.getIndex("reverbDamp");
+    reverbMixIndex = smoothers.getIndex("reverbMix");
+    reverbShimmerIndex = smoothers.getIndex("reverbShimmer");
+    distortionOversampling = apvts.getRawParameterValue("distortionOversampling");
+    oversamplingQuality = apvts.getRawParameterValue("oversamplingQuality");
+    distortionShape = apvts.getRawParameterValue("distortionShape");
+    distortionAntialiasing = apvts.getRawParameterValue("distortionAntialiasing");
+    delaySync = apvts.getRawParameterValue("delaySync");
+    delayMode = apvts.getRawParameterValue("delayMode");
+    reverbMode = apvts.getRawParameterValue("reverbMode");
+
+    jassert(distortionDriveIndex >= 0 && distortionMixIndex >= 0);
+    jassert(delayTimeIndex >= 0 && delayFeedbackIndex >= 0 && delayMixIndex >= 0 && delayWowIndex >= 0);
+    jassert(delaySync != nullptr && delayMode != nullptr && reverbMode != nullptr);
+    jassert(reverbSizeIndex >= 0 && reverbDampIndex >= 0 && reverbMixIndex >= 0 && reverbShimmerIndex >= 0);
+    jassert(distortionOversampling != nullptr && oversamplingQuality != nullptr);
+    jassert(distortionShape != nullptr && distortionAntialiasing != nullptr);
+}
+
+void EffectChain::prepare(double newSampleRate, int newMaxBlockSize, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    maxBlockSize = juce::jmax(1, newMaxBlockSize);
+    numChannels = juce::jmax(1, newNumChannels);
+
+    // Every oversampling setting up front, so switching never allocates
+    distortionOversampler.prepare(numChannels, maxBlockSize);
+    distortionDryDelay.setMaximumDelayInSamples(distortionOversampler.getMaximumLatencyInSamples() + 1);
+    distortionDryDelay.prepare({ sampleRate, (juce::uint32) maxBlockSize, (juce::uint32) numChannels });
+
+    delay.prepare(sampleRate);
+    reverb.prepare(sampleRate);
+
+    dryBuffer.setSize(numChannels, maxBlockSize);
+    wetBuffer.setSize(2, maxBlockSize);
+
+    updateSettings();
+    reset();
+}
+
+void EffectChain::reset()
+{
+    distortionOversampler.reset();
+    distortionDryDelay.reset();
+    distortion.reset();
+    distortionActive = false;
+    delay.reset();
+    delayActive = false;
+    reverb.reset();
+    reverbActive = false;
+
+    silentSamples = silenceCap;
+}
+
+void EffectChain::process(juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+    const int channels = juce::jmin(buffer.getNumChannels(), numChannels);
+
+    bool silent = true;
+    for (int ch = 0; ch < buffer.getNumChannels() && silent; ++ch)
+        silent = buffer.getMagnitude(ch, 0, numSamples) < SynthLayer::silenceThreshold;
+    silentSamples = silent ? juce::jmin(silentSamples, silenceCap - numSamples) + numSamples : 0;
+
+    updateSettings();
+
+    // Hosts may exceed the announced block size, so run in prepared-size pieces
+    juce::dsp::AudioBlock<float> block(buffer.getArrayOfWritePointers(), (size_t) channels, (size_t) numSamples);
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize)
+    {
+        const int n = juce::jmin(maxBlockSize, numSamples - offset);
+        auto piece = block.getSubBlock((size_t) offset, (size_t) n);
+        processDistortion(piece, offset);
+        processDelay(piece, offset);
+        processReverb(piece, offset);
+    }
+}
+
+void EffectChain::setTempo(double bpm)
+{
+    if (bpm > 0.0)
+        tempo = bpm;
+}
+
+double EffectChain::getTailLengthSeconds() const
+{
+    // The waveshaper only remembers two samples; the delay repeats into the reverb
+    const double delayTail = isBypassed(delayMixIndex) ? 0.0 : delay.getTailLengthSeconds();
+    const double reverbTail = isBypassed(reverbMixIndex) ? 0.0 : reverb.getTailLengthSeconds();
+    return delayTail + reverbTail;
+}
+
+bool EffectChain::isIdle() const
+{
+    const int tailSamples = (int) std::ceil(getTailLengthSeconds() * sampleRate);
+    return silentSamples > getLatencySamples() + tailSamples;
+}
+
+void EffectChain::updateSettings()
+{
+    const int choice = juce::jlimit(0, 3, (int) distortionOversampling->load());
+    distortionOversampler.setQuality((Oversampler::Quality) juce::jlimit(0, 1, (int) oversamplingQuality->load()));
+    distortionOversampler.setFactor(1 << choice);
+
+    distortion.setShape((int) distortionShape->load());
+    distortion.setOrder((int) distortionAntialiasing->load() + 1);
+    delay.setMode((int) delayMode->load());
+    reverb.setMode((int) reverbMode->load());
+
+    // A bypassed distortion needs no dry delay, so it costs the host no latency either
+    distortionLatency = isBypassed(distortionMixIndex) ? 0 : getDistortionLatency();
+    distortionDryDelay.setDelay((float) distortionLatency);
+}
+
+int EffectChain::getDistortionLatency() const
+{
+    // The shaper's own delay is at the oversampled rate, so a fraction of a host sample. The dry
+    // delay and the host only take whole samples: round it to the nearest rather than dropping it
+    const float shaperLatency = distortion.getLatencyInSamples() / (float) distortionOversampler.getFactor();
+    return distortionOversampler.getLatencyInSamples() + (int) std::lround(shaperLatency);
+}
+
+void EffectChain::processDistortion(juce::dsp::AudioBlock<float>& block, int startSample)
+{
+    const int n = (int) block.getNumSamples();
+    const int channels = (int) block.getNumChannels();
+
+    // The dry signal, delayed to line up with the oversampled wet one
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const float* input = block.getChannelPointer((size_t) ch);
+        float* dry = dryBuffer.getWritePointer(ch);
+
+        for (int i = 0; i < n; ++i)
+        {
+            distortionDryDelay.pushSample(ch, input[i]);
+            dry[i] = distortionDryDelay.popSample(ch);
+        }
+    }
+
+    // Bypassed at zero mix; the dry delay is zero then, as updateSettings() told the host
+    if (isBypassed(distortionMixIndex))
+    {
+        for (int ch = 0; ch < channels; ++ch)
+            juce::FloatVectorOperations::copy(block.getChannelPointer((size_t) ch), dryBuffer.getReadPointer(ch), n);
+        distortionActive = false;
+        return;
+    }
+
+    // Drive ramps to its value at the end of the piece, inside the oversampled block
+    distortion.setDrive(smoothers.getValueAt(distortionDriveIndex, startSample + n - 1));
+
+    if (! distortionActive)
+    {
+        // Waking from bypass: the filters hold stale history and the drive may have moved
+        distortionOversampler.reset();
+        distortion.reset();
+        distortionActive = true;
+    }
+
+    distortionOversampler.process(block, [this](juce::dsp::AudioBlock<float>& oversampled) {
+        distortion.process(oversampled);
+    });
+
+    // wet = dry + mix * (wet - dry), with the mix ramped per sample
+    const float* mix = smoothers.getRamp(distortionMixIndex, startSample, n);
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        float* wet = block.getChannelPointer((size_t) ch);
+        const float* dry = dryBuffer.getReadPointer(ch);
+
+        juce::FloatVectorOperations::subtract(wet, dry, n);
+        juce::FloatVectorOperations::multiply(wet, mix, n);
+        juce::FloatVectorOperations::add(wet, dry, n);
+    }
+}
+
+void EffectChain::processDelay(juce::dsp::AudioBlock<float>& block, int startSample)
+{
+    if (isBypassed(delayMixIndex))
+    {
+        delayActive = false;
+        return;
+    }
+
+    if (! delayActive)
+    {
+        // Waking from bypass: the buffers still hold the repeats they were cut off in
+        delay.reset();
+        delayActive = true;
+    }
+
+    // A synced time follows the tempo; a new time glides inside the delay
+    const int n = (int) block.getNumSamples();
+    const int last = startSample + n - 1;
+    const double beats = syncBeats[(size_t) juce::jlimit(0, (int) syncBeats.size() - 1, (int) delaySync->load())];
+    delay.setDelayTime(beats > 0.0 ? beats * 60.0 / tempo : (double) smoothers.getValueAt(delayTimeIndex, last));
+    delay.setFeedback(smoothers.getValueAt(delayFeedbackIndex, last));
+    delay.setWow(smoothers.getValueAt(delayWowIndex, last));
+
+    loadWet(block);
+    delay.process(wetBuffer.getWritePointer(0), wetBuffer.getWritePointer(1), n);
+    addWet(block, delayMixIndex, startSample);
+}
+
+void EffectChain::processReverb(juce::dsp::AudioBlock<float>& block, int startSample)
+{
+    if (isBypassed(reverbMixIndex))
+    {
+        reverbActive = false;
+        return;
+    }
+
+    if (! reverbActive)
+    {
+        // Waking from bypass: the network still holds the tail it was cut off in
+        reverb.reset();
+        reverbActive = true;
+    }
+
+    // Size, damping and shimmer move once per piece; size glides inside the reverb anyway
+    const int n = (int) block.getNumSamples();
+    const int last = startSample + n - 1;
+    reverb.setSize(smoothers.getValueAt(reverbSizeIndex, last));
+    reverb.setDamping(smoothers.getValueAt(reverbDampIndex, last));
+    reverb.setShimmer(smoothers.getValueAt(reverbShimmerIndex, last));
+
+    loadWet(block);
+    reverb.process(wetBuffer.getWritePointer(0), wetBuffer.getWritePointer(1), n);
+    addWet(block, reverbMixIndex, startSample);
+}
+
+bool EffectChain::isBypassed(int mixIndex) const
+{
+    return ! smoothers.isSmoothing(mixIndex) && smoothers.getTargetValue(mixIndex) <= 0.0f;
+}
+
+void EffectChain::loadWet(const juce::dsp::AudioBlock<float>& block)
+{
+    const int n = (int) block.getNumSamples();
+    const int lastChannel = (int) block.getNumChannels() - 1;
+
+    juce::FloatVectorOperations::copy(wetBuffer.getWritePointer(0), block.getChannelPointer(0), n);
+    juce::FloatVectorOperations::copy(wetBuffer.getWritePointer(1), block.getChannelPointer((size_t) juce::jmin(1, lastChannel)), n);
+}
+
+void EffectChain::addWet(juce::dsp::AudioBlock<float>& block, int mixIndex, int startSample)
+{
+    const int n = (int) block.getNumSamples();
+    const int channels = (int) block.getNumChannels();
+    float* left = wetBuffer.getWritePointer(0);
+    float* right = wetBuffer.getWritePointer(1);
+
+    if (channels == 1)
+    {
+        juce::FloatVectorOperations::add(left, right, n);
+        juce::FloatVectorOperations::multiply(left, 0.5f, n);
+    }
+
+    // out = dry + mix * wet
+    const float* mix = smoothers.getRamp(mixIndex, startSample, n);
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        float* wet = wetBuffer.getWritePointer(juce::jmin(ch, 1));
+        juce::FloatVectorOperations::multiply(wet, mix, n);
+        juce::FloatVectorOperations::add(block.getChannelPointer((size_t) ch), wet, n);
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include "DelayFX.h"
+#include "DistortionFX.h"
+#include "ReverbFX.h"
+#include "../Oversampler.h"
+#include "../../Core/SmootherBank.h"
+
+/**
+ * EffectChain - The master effects, between the engine and the master volume.
+ *
+ * Nonlinear stages run inside their own Oversampler, at the factor their
+ * parameter selects, so only they pay for the higher rate. Their dry signal is
+ * delayed by the same whole-sample latency before the mix, which lets the
+ * processor report it to the host. A stage with its mix at zero is bypassed
+ * and adds no latency, so patches without distortion run without plugin delay
+ * compensation; the latency, and the host's report, only change when the
+ * distortion is switched in or out or its factor changes. The delay and then the reverb follow
+ * the distortion and are added on top of the dry signal. Both are always
+ * stereo, so a mono bus is fed to both sides and summed back.
+ *
+ * The chain also tracks how long its input has been silent: once that exceeds
+ * every effect's tail plus the latency, isIdle() lets the processor skip
+ * blocks entirely.
+ *
+ * Parameters are read from the processor's SmootherBank (floats) and raw
+ * handles (choices). Everything on the process() path is allocation-free.
+ */
+class EffectChain
+{
+public:
+    EffectChain(juce::AudioProcessorValueTreeState& apvts, SmootherBank& smoothers);
+
+    // Allocates every stage and delay for blocks of up to maxBlockSize (message thread)
+    void prepare(double newSampleRate, int newMaxBlockSize, int newNumChannels);
+    void reset();
+
+    // Processes the engine's output in place; any block size, any channel count up to the prepared one
+    void process(juce::AudioBuffer<float>& buffer);
+
+    // Host tempo for the synced delay times; kept until the host reports another
+    void setTempo(double bpm);
+
+    // Offline renders wait for the convolution's background tail instead of dropping late blocks
+    void setNonRealtime(bool isNonRealtime) { reverb.getConvolver().setWaitForTail(isNonRealtime); }
+
+    ConvolutionReverb& getConvolutionReverb() { return reverb.getConvolver(); }
+
+    // Latency of the current settings, in samples - changes with an oversampling factor and
+    // when the distortion leaves or enters bypass
+    int getLatencySamples() const { return distortionLatency; }
+
+    double getTailLengthSeconds() const;
+
+    // True once the input has been silent for longer than the chain's tail and latency
+    bool isIdle() const;
+
+private:
+    SmootherBank& smoothers;
+
+    // Smoother indices, resolved once
+    int distortionDriveIndex = -1;
+    int distortionMixIndex = -1;
+    int delayTimeIndex = -1;
+    int delayFeedbackIndex = -1;
+    int delayMixIndex = -1;
+    int delayWowIndex = -1;
+    int reverbSizeIndex = -1;
+    int reverbDampIndex = -1;
+    int reverbMixIndex = -1;
+    int reverbShimmerIndex = -1;
+
+    // Choice parameters, read per block
+    std::atomic<float>* distortionOversampling = nullptr; // 0 = 1x, 1 = 2x, 2 = 4x, 3 = 8x
+    std::atomic<float>* oversamplingQuality = nullptr; // Oversampler::Quality
+    std::atomic<float>* distortionShape = nullptr; // DistortionFX::Shape
+    std::atomic<float>* distortionAntialiasing = nullptr; // 0 = first-order ADAA, 1 = second-order
+    std::atomic<float>* delaySync = nullptr; // 0 = free time, then note values, see EffectChain.cpp
+    std::atomic<float>* delayMode = nullptr; // DelayFX::Mode
+    std::atomic<float>* reverbMode = nullptr; // ReverbFX::Mode
+
+    double sampleRate = 44100.0;
+    int maxBlockSize = 512;
+    int numChannels = 2;
+    double tempo = 120.0;
+
+    // Distortion: ADAA waveshaper, optionally oversampled, and its dry path delayed to match
+    DistortionFX distortion;
+    Oversampler distortionOversampler;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> distortionDryDelay;
+    bool distortionActive = false; // False while bypassed at zero mix
+    int distortionLatency = 0; // Host samples, zero while bypassed
+
+    // Delay: tape or ping-pong, cleared when it wakes from bypass
+    DelayFX delay;
+    bool delayActive = false;
+
+    // Reverb: feedback delay network, cleared when it wakes from bypass
+    ReverbFX reverb;
+    bool reverbActive = false;
+
+    juce::AudioBuffer<float> dryBuffer;
+    juce::AudioBuffer<float> wetBuffer; // Stereo, whatever the bus
+
+    // Consecutive silent input samples, capped so it never overflows
+    static constexpr int silenceCap = 1 << 30;
+    int silentSamples = silenceCap;
+
+    // Picks up the choice parameters; a new latency applies from this block
+    void updateSettings();
+
+    int getDistortionLatency() const;
+
+    void processDistortion(juce::dsp::AudioBlock<float>& block, int startSample);
+    void processDelay(juce::dsp::AudioBlock<float>& block, int startSample);
+    void processReverb(juce::dsp::AudioBlock<float>& block, int startSample);
+
+    // Stereo sends: the block into wetBuffer, then wetBuffer times the mix ramp added back
+    bool isBypassed(int mixIndex) const;
+    void loadWet(const juce::dsp::AudioBlock<float>& block);
+    void addWet(juce::dsp::AudioBlock<float>& block, int mixIndex, int startSample);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectChain)
+};
@@ -0,0 +1,258 @@
+#include "ReverbFX.h"
+#include <cmath>
+
+namespace
+{
+    // Line lengths at 48 kHz and full size: primes spaced evenly on a log scale from 23 to 96 ms
+    constexpr std::array<float, ReverbFX::numLines> baseDelays {
+        1103.0f, 1213.0f, 1361.0f, 1471.0f, 1613.0f, 1777.0f, 1951.0f, 2153.0f,
+        2371.0f, 2609.0f, 2857.0f, 3163.0f, 3457.0f, 3803.0f, 4201.0f, 4603.0f
+    };
+
+    constexpr double baseRate = 48000.0;
+    constexpr float minimumScale = 0.3f; // Line lengths at zero size
+    constexpr float maxGlide = 0.05f; // Delay change per sample: resizing bends pitch by at most 5%
+    constexpr float modulationSeconds = 0.00017f; // Delay swing of the line LFOs
+    constexpr float outputGain = 0.5f;
+    constexpr float shimmerLimit = 0.95f; // Shimmer's share of the loop gain at full shimmer
+}
+
+void ReverbFX::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    modulationDepth = modulationSeconds * (float) sampleRate;
+
+    // Longest line at full size, plus the modulation swing and the interpolation's extra frame
+    const float rateScale = (float) (sampleRate / baseRate);
+    const int longest = (int) std::ceil(baseDelays.back() * rateScale + modulationDepth) + 2;
+    const int frames = juce::nextPowerOfTwo(longest);
+    memory.assign((size_t) (frames * numLines), 0.0f);
+    mask = frames - 1;
+
+    // LFO rates spread from 0.15 to 0.95 Hz, so no two lines beat together
+    for (int l = 0; l < numLines; ++l)
+    {
+        const double rate = 0.15 + 0.8 * (double) l / (double) (numLines - 1);
+        const double increment = juce::MathConstants<double>::twoPi * rate / sampleRate;
+        lfoRotationCos[(size_t) l] = (float) std::cos(increment);
+        lfoRotationSin[(size_t) l] = (float) std::sin(increment);
+    }
+
+    // A 40 ms grain window, read from at least one block back
+    shimmerWindow = (float) (0.04 * sampleRate);
+    const int shimmerFrames = juce::nextPowerOfTwo((int) shimmerWindow + blockSize + 4);
+    shimmerMemory.assign((size_t) shimmerFrames, 0.0f);
+    shimmerMask = shimmerFrames - 1;
+    shimmerHighpassCoefficient = (float) (1.0 - std::exp(-juce::MathConstants<double>::twoPi * 200.0 / sampleRate));
+
+    // Both depend on the sample rate
+    setSize(size);
+    setDamping(damping);
+
+    convolver.prepare(sampleRate);
+    reset();
+}
+
+void ReverbFX::reset()
+{
+    convolver.reset();
+
+    std::fill(memory.begin(), memory.end(), 0.0f);
+    std::fill(shimmerMemory.begin(), shimmerMemory.end(), 0.0f);
+    position = 0;
+    shimmerPosition = 0;
+    shimmerPhase = 0.0f;
+    shimmerLowpass = 0.0f;
+
+    dampingStates.fill(0.0f);
+    for (int l = 0; l < numLines; ++l)
+    {
+        const float phase = 2.4f * (float) l;
+        lfoCos[(size_t) l] = std::cos(phase);
+        lfoSin[(size_t) l] = std::sin(phase);
+    }
+
+    // Start at the current size rather than gliding there
+    delays = sizeDelays;
+    delayTargets = sizeDelays;
+    gainsDirty = true;
+}
+
+void ReverbFX::setMode(int newMode)
+{
+    newMode = juce::jlimit((int) algorithmic, (int) convolution, newMode);
+    if (newMode == mode)
+        return;
+
+    mode = newMode;
+    reset();
+}
+
+void ReverbFX::setSize(float amount)
+{
+    size = juce::jlimit(0.0f, 1.0f, amount);
+
+    // 0.4 to 20 seconds, exponentially, so the knob feels even
+    decayTime = 0.4f * std::pow(50.0f, size);
+
+    const float scale = (minimumScale + (1.0f - minimumScale) * size) * (float) (sampleRate / baseRate);
+    float meanDelay = 0.0f;
+    for (int l = 0; l < numLines; ++l)
+    {
+        sizeDelays[(size_t) l] = baseDelays[(size_t) l] * scale;
+        meanDelay += sizeDelays[(size_t) l] / (float) numLines;
+    }
+
+    // Long decays build up more energy, so the input is scaled to keep the sustained level constant
+    meanGain = std::pow(10.0f, -3.0f * meanDelay / (decayTime * (float) sampleRate));
+    inputGain = std::sqrt(1.0f - meanGain * meanGain);
+    gainsDirty = true;
+}
+
+void ReverbFX::setDamping(float amount)
+{
+    damping = juce::jlimit(0.0f, 1.0f, amount);
+
+    // One-pole lowpass from 18 kHz down to about 560 Hz
+    const double cutoff = juce::jmin(18000.0 * std::pow(2.0, -5.0 * damping), 0.45 * sampleRate);
+    dampingCoefficient = (float) (1.0 - std::exp(-juce::MathConstants<double>::twoPi * cutoff / sampleRate));
+}
+
+void ReverbFX::setShimmer(float amount)
+{
+    shimmer = juce::jlimit(0.0f, 1.0f, amount);
+}
+
+void ReverbFX::process(float* left, float* right, int numSamples)
+{
+    if (mode == convolution)
+    {
+        convolver.process(left, right, numSamples);
+        return;
+    }
+
+    const auto& kernels = DspKernels::get();
+
+    for (int offset = 0; offset < numSamples; offset += blockSize)
+    {
+        const int n = juce::jmin(blockSize, numSamples - offset);
+        float* blockLeft = left + offset;
+        float* blockRight = right + offset;
+
+        updateLines(n);
+
+        if (shimmer > 0.0f)
+        {
+            readShimmer(n);
+            const float feedback = getShimmerFeedback();
+            for (int i = 0; i < n; ++i)
+            {
+                blockLeft[i] += shimmerBlock[(size_t) i] * feedback;
+                blockRight[i] += shimmerBlock[(size_t) i] * feedback;
+            }
+        }
+
+        const DspKernels::ReverbLines lines {
+            memory.data(), mask, &position,
+            delays.data(), delayTargets.data(),
+            lfoCos.data(), lfoSin.data(), lfoRotationCos.data(), lfoRotationSin.data(), modulationDepth,
+            gains.data(), dampingStates.data(), dampingCoefficient,
+            inputGain, outputGain
+        };
+
+        kernels.reverbFrames(lines, blockLeft, blockRight, n);
+
+        // Kept up to date even without shimmer, so turning it up never reads old audio
+        writeShimmer(blockLeft, blockRight, n);
+    }
+}
+
+double ReverbFX::getTailLengthSeconds() const
+{
+    if (mode == convolution)
+        return convolver.getTailLengthSeconds();
+
+    // The shimmer adds its share to the loop gain, which stretches the decay
+    const double gain = juce::jlimit(1.0e-6, 0.999999, (double) meanGain);
+    const double withShimmer = gain + shimmerLimit * shimmer * (1.0 - gain);
+    return 2.0 * decayTime * std::log(gain) / std::log(juce::jmin(withShimmer, 0.999999));
+}
+
+void ReverbFX::updateLines(int numSamples)
+{
+    const float maxStep = maxGlide * (float) numSamples;
+    bool moving = false;
+
+    for (int l = 0; l < numLines; ++l)
+    {
+        const float step = juce::jlimit(-maxStep, maxStep, sizeDelays[(size_t) l] - delayTargets[(size_t) l]);
+        delayTargets[(size_t) l] += step;
+        moving = moving || step != 0.0f;
+    }
+
+    if (! moving && ! gainsDirty)
+        return;
+
+    // Each line loses 60 dB per decayTime, whatever its length
+    const float decayScale = -3.0f / (decayTime * (float) sampleRate);
+    for (int l = 0; l < numLines; ++l)
+        gains[(size_t) l] = std::pow(10.0f, decayScale * delayTargets[(size_t) l]);
+
+    gainsDirty = false;
+}
+
+void ReverbFX::readShimmer(int numSamples)
+{
+    // Each grain's delay shrinks by one sample per sample, so it reads at double speed:
+    // an octave up. Two grains half a window apart crossfade with sin^2 windows that
+    // sum to one and are silent where a grain jumps back.
+    const float minimumDelay = (float) blockSize + 2.0f;
+    const float phaseStep = 1.0f / shimmerWindow;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float sum = 0.0f;
+
+        for (const float grainOffset : { 0.0f, 0.5f })
+        {
+            float phase = shimmerPhase + grainOffset;
+            phase -= std::floor(phase);
+
+            const float read = (float) (shimmerPosition + i) - (minimumDelay + shimmerWindow * (1.0f - phase));
+            const float whole = std::floor(read);
+            const float frac = read - whole;
+            const int at = (int) whole;
+
+            const float a = shimmerMemory[(size_t) (at & shimmerMask)];
+            const float b = shimmerMemory[(size_t) ((at + 1) & shimmerMask)];
+            const float window = std::sin(juce::MathConstants<float>::pi * phase);
+
+            sum += (a + (b - a) * frac) * window * window;
+        }
+
+        shimmerBlock[(size_t) i] = sum;
+
+        shimmerPhase += phaseStep;
+        shimmerPhase -= std::floor(shimmerPhase);
+    }
+}
+
+void ReverbFX::writeShimmer(const float* left, const float* right, int numSamples)
+{
+    // Highpassed: the lows are where an octave up lands closest to itself, and would build up
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float x = 0.5f * (left[i] + right[i]);
+        shimmerLowpass += (x - shimmerLowpass) * shimmerHighpassCoefficient;
+        shimmerMemory[(size_t) ((shimmerPosition + i) & shimmerMask)] = x - shimmerLowpass;
+    }
+
+    shimmerPosition = (shimmerPosition + numSamples) & shimmerMask;
+}
+
+float ReverbFX::getShimmerFeedback() const
+{
+    // Scaled so the shifted octaves decay no slower than the tail itself at full shimmer.
+    // The input gain is undone because the kernel applies it to the feedback too.
+    return shimmerLimit * shimmer * (1.0f - meanGain) / juce::jmax(inputGain, 1.0e-3f);
+}
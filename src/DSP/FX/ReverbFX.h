@@ -1,9 +1,115 @@
 #pragma once
 #include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <vector>
+#include "ConvolutionReverb.h"
+#include "../Kernels/DspKernels.h"
+
+/**
+ * ReverbFX - Sixteen-line feedback delay network with an optional shimmer.
+ *
+ * Each line is a modulated delay with a one-pole damping filter and a decay
+ * gain set from the decay time and the line's length. The line outputs are
+ * mixed by an orthonormal 16-point Hadamard matrix and fed back with the
+ * input. All sixteen lines are one frame of a shared ring buffer, so each
+ * sample is one SIMD pass (DspKernels::reverbFrames). The lines' lengths are
+ * mutually prime and each one's slow LFO runs at its own rate, which smears
+ * the modes into a smooth tail.
+ *
+ * Size scales the line lengths and the decay time together, from a small room
+ * to a 20 second wash. Line lengths glide to a new size at a bounded rate, so
+ * turning the knob bends pitch slightly instead of clicking. The shimmer
+ * pitches the wet signal up an octave with a two-grain delay-line shifter and
+ * feeds it back into the network, one block behind. Every pass then adds
+ * another octave, until the damping takes the highs away.
+ *
+ * In convolution mode the network rests and the signal runs through a loaded
+ * impulse response instead (ConvolutionReverb); size, damping and shimmer
+ * only shape the algorithmic mode.
+ *
+ * process() replaces its input with the wet signal. All memory is allocated
+ * in prepare().
+ */
 class ReverbFX {
 public:
-    void process(float* data, int numSamples) {
-        // Simple placeholder: pass-through
-        // TODO: Replace with JUCE::Reverb or custom algo
-    }
+    static constexpr int numLines = DspKernels::reverbLines;
+
+    // Matches the "reverbMode" parameter choices
+    enum Mode
+    {
+        algorithmic = 0,
+        convolution
+    };
+
+    void prepare(double newSampleRate);
+    void reset();
+
+    // Switching clears the mode switched to, so it never replays a stale tail
+    void setMode(int newMode);
+
+    // Impulse responses are loaded into this; see ResourceManager::loadImpulseResponse
+    ConvolutionReverb& getConvolver() { return convolver; }
+
+    void setSize(float amount); // 0 - 1
+    void setDamping(float amount); // 0 - 1, 1 = darkest
+    void setShimmer(float amount); // 0 - 1, 1 = octaves sustain as long as the tail
+
+    // Replaces left and right with the reverb's wet output
+    void process(float* left, float* right, int numSamples);
+
+    // Time for the tail to fall by 120 dB, shimmer included
+    double getTailLengthSeconds() const;
+
+private:
+    static constexpr int blockSize = 32; // Shimmer feedback lags by at most this much
+
+    double sampleRate = 44100.0;
+    int mode = algorithmic;
+
+    ConvolutionReverb convolver;
+
+    float size = 0.5f;
+    float damping = 0.3f;
+    float shimmer = 0.0f;
+    float decayTime = 1.0f; // Seconds to fall by 60 dB
+
+    // Network memory: numLines interleaved ring buffers
+    std::vector<float> memory;
+    int mask = 0;
+    int position = 0;
+
+    // Per-line state; delays glide towards the size's lengths, at most maxGlide samples per sample
+    alignas(32) std::array<float, numLines> delays {};
+    alignas(32) std::array<float, numLines> delayTargets {};
+    alignas(32) std::array<float, numLines> sizeDelays {};
+    alignas(32) std::array<float, numLines> gains {};
+    alignas(32) std::array<float, numLines> dampingStates {};
+    alignas(32) std::array<float, numLines> lfoCos {};
+    alignas(32) std::array<float, numLines> lfoSin {};
+    alignas(32) std::array<float, numLines> lfoRotationCos {};
+    alignas(32) std::array<float, numLines> lfoRotationSin {};
+    float modulationDepth = 0.0f;
+    float dampingCoefficient = 1.0f;
+    float inputGain = 1.0f;
+    float meanGain = 0.0f; // Geometric mean of the line gains
+    bool gainsDirty = true;
+
+    // Shimmer: ring buffer of the mono wet signal, read by two crossfaded grains
+    std::vector<float> shimmerMemory;
+    int shimmerMask = 0;
+    int shimmerPosition = 0;
+    float shimmerPhase = 0.0f; // 0 - 1 through the grain window
+    float shimmerWindow = 2048.0f; // Grain length in samples
+    float shimmerHighpassCoefficient = 0.0f;
+    float shimmerLowpass = 0.0f; // One-pole state; the signal minus it is the highpass
+    alignas(32) std::array<float, blockSize> shimmerBlock {};
+
+    // Glides the delays and refreshes the gains they depend on
+    void updateLines(int numSamples);
+
+    // Reads numSamples of the octave-up wet signal into shimmerBlock
+    void readShimmer(int numSamples);
+    void writeShimmer(const float* left, const float* right, int numSamples);
+
+    float getShimmerFeedback() const;
 };
@@ -0,0 +1,36 @@
+#include "DspKernels.h"
+#include <juce_core/juce_core.h>
+
+// Each Kernels_*.cpp file defines one of these
+namespace DspKernelsBaseline { const DspKernels& getKernels(); }
+
+#if VOID_KERNELS_X86
+namespace DspKernelsAvx2 { const DspKernels& getKernels(); }
+namespace DspKernelsAvx512 { const DspKernels& getKernels(); }
+#endif
+
+namespace
+{
+    const DspKernels& selectKernels()
+    {
+       #if VOID_KERNELS_X86
+        using Stats = juce::SystemStats;
+
+        // JUCE's flags include the OS check (XGETBV) that the wide registers are saved
+        if (Stats::hasAVX512F() && Stats::hasAVX512VL() && Stats::hasAVX512DQ() && Stats::hasAVX512BW())
+            return DspKernelsAvx512::getKernels();
+
+        if (Stats::hasAVX2() && Stats::hasFMA3())
+            return DspKernelsAvx2::getKernels();
+       #endif
+
+        return DspKernelsBaseline::getKernels();
+    }
+}
+
+const DspKernels& DspKernels::get()
+{
+    // Chosen once - the first call comes from prepareToPlay, never the audio thread
+    static const DspKernels& kernels = selectKernels();
+    return kernels;
+}
@@ -0,0 +1,197 @@
+#pragma once
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+ #define VOID_KERNELS_X86 1
+#else
+ #define VOID_KERNELS_X86 0
+#endif
+
+/**
+ * DspKernels - The engine's hot inner loops, built once per instruction set.
+ *
+ * Each Kernels_*.cpp file compiles the same DspKernelsImpl.h with different
+ * target flags (set per source file in CMakeLists.txt): a baseline build
+ * (SSE2 on x86-64, NEON on arm64), AVX2 + FMA and AVX-512. get() checks the
+ * CPU once and returns the widest variant it can run, so one binary runs on
+ * old machines and still uses the full vector width on new ones.
+ *
+ * The DSP classes keep their state and call through this table; the kernels
+ * only see plain arrays. Lane counts are fixed at numLanes, the width of the
+ * voice and filter banks.
+ */
+struct DspKernels
+{
+    static constexpr int numLanes = 8;
+    static constexpr int reverbLines = 16;
+    static constexpr int delayChunk = 32; // delayFrames reads this far ahead of its writes
+
+    enum class InstructionSet
+    {
+        generic,
+        sse2,
+        avx2,
+        avx512,
+        neon
+    };
+
+    // Eight TPT state-variable filters, see StateVariableFilterBank
+    struct FilterLanes
+    {
+        float* g;              // Coefficients, ramped towards the targets across the call
+        float* k;
+        const float* gTarget;
+        const float* kTarget;
+        float* s1;             // Integrator states
+        float* s2;
+        float lowGain;         // Response mix: exactly one of these is 1
+        float bandGain;
+        float highGain;
+    };
+
+    // Eight ZDF 4-pole ladder filters, see DarkFilter
+    struct LadderLanes
+    {
+        float* cutoffs;              // pi * fc / fs per lane, ramped towards the targets across the call
+        const float* cutoffTargets;
+        float* states;               // Four rows of numLanes integrator states, one per pole
+        const float* modulation;     // Frames of cutoff modulation; nullptr for none
+        float modulationDepth;       // Octaves per unit of modulation
+        float feedback;              // 0 - 4, self-oscillates at 4
+        float inputGain;
+    };
+
+    // Rows of eight PolyBLEP oscillators, see OscillatorLayer
+    struct PolyBlepLanes
+    {
+        float* phases;               // numOscillators rows of numLanes
+        const float* increments;
+        const float* gains;          // Per lane
+        const float* leftGains;      // Per row; rightGains is only read for stereo output
+        const float* rightGains;
+        int numOscillators;
+        int shape;                   // WaveTableBank::Waveform
+        int previousShape;           // Faded out from startFade, falling by fadeStep per sample
+        float startFade;
+        float fadeStep;
+    };
+
+    // Rows of detuned wavetable oscillators for eight voices, see OscillatorLayer
+    struct WavetableLanes
+    {
+        const float* table;          // Mip level 0 of the current table, levels back to back
+        const float* previousTable;  // Faded out like PolyBlepLanes; nullptr when not fading
+        float startFade;
+        float fadeStep;
+        float* phases;               // numOscillators rows of numLanes
+        const float* increments;
+        const int* levelOffsets;     // Offset of each lane's mip level from table
+        const float* gains;          // Per lane
+        const float* leftGains;      // Per row; rightGains is only read for stereo output
+        const float* rightGains;
+        int numOscillators;
+        int tableSize;
+    };
+
+    // Feedback delay network of reverbLines modulated delay lines, see ReverbFX
+    struct ReverbLines
+    {
+        float* memory;               // Ring buffer, memory[(frame & mask) * reverbLines + line]
+        int mask;                    // Ring buffer length in frames minus one, a power of two minus one
+        int* position;               // Frame written next, advanced across the call
+        float* delays;               // Per line, in samples, ramped towards the targets across the call
+        const float* delayTargets;
+        float* lfoCos;               // Per-line modulation phasors, rotated by lfoRotationCos/Sin per sample
+        float* lfoSin;
+        const float* lfoRotationCos;
+        const float* lfoRotationSin;
+        float modulationDepth;       // Delay swing in samples
+        const float* gains;          // Per line: decay per pass through the line
+        float* damping;              // Per line: one-pole lowpass states
+        float dampingCoefficient;    // 0 - 1, 1 leaves the highs alone
+        float inputGain;
+        float outputGain;
+    };
+
+    // Stereo tape / ping-pong delay, see DelayFX
+    struct DelayLines
+    {
+        float* memoryLeft;           // Ring buffers, one per side
+        float* memoryRight;
+        int mask;                    // Ring buffer length minus one, a power of two minus one
+        int* position;               // Sample written next, advanced across the call
+        float startDelay;            // In samples, ramped by delayStep per sample
+        float delayStep;
+        float* wowPhase;             // 0 - 1, advanced across the call
+        float wowIncrement;
+        float wowDepth;              // Delay swing in samples
+        float* flutterPhase;
+        float flutterIncrement;
+        float flutterDepth;
+        float* tone;                 // Two one-pole lowpass states on the feedback
+        float toneCoefficient;       // 0 - 1, 1 leaves the highs alone
+        float feedback;
+        float pingPong;              // 0 = each side feeds itself, 1 = the sides swap every repeat
+    };
+
+    // One channel of an antiderivative anti-aliased waveshaper, see DistortionFX
+    struct ShaperChannel
+    {
+        double* history;             // The last two driven inputs, newest first
+        int shape;                   // DistortionFX::Shape
+        int order;                   // 1 or 2
+        float startGain;             // Drive gain, ramped by gainStep per sample
+        float gainStep;
+        float startLevel;            // Output level, ramped by levelStep per sample
+        float levelStep;
+    };
+
+    // destination[i] += source[i] * (startGain + gainStep * i)
+    void (*accumulateRamp)(float* destination, const float* source, float startGain, float gainStep, int numSamples);
+
+    // The same for a mono source panned into two destinations
+    void (*accumulateRampPanned)(float* left, float* right, const float* source,
+                                 float startLeft, float stepLeft, float startRight, float stepRight, int numSamples);
+
+    // Filters interleaved frames[i * numLanes + lane] in place; numSamples <= the coefficient ramp length
+    void (*filterFrames)(const FilterLanes& lanes, float* frames, int numSamples);
+
+    // Filters interleaved frames[i * numLanes + lane] in place through the ladders
+    void (*ladderFrames)(const LadderLanes& lanes, float* frames, int numSamples);
+
+    // Oscillator banks: every row adds into its lane of leftFrames and, unless it is
+    // nullptr, rightFrames - scaled by the lane gain times the row's gain for that side
+    void (*polyBlepFrames)(const PolyBlepLanes& lanes, float* leftFrames, float* rightFrames, int numSamples);
+    void (*wavetableFrames)(const WavetableLanes& lanes, float* leftFrames, float* rightFrames, int numSamples);
+
+    // Envelopes, see EnvelopeBank: levels[lane] = levels[lane] * coefficients[lane] + offsets[lane]
+    // once per sample, every sample's levels stored as frames[i * numLanes + lane]
+    void (*envelopeFrames)(float* levels, const float* coefficients, const float* offsets, float* frames, int numSamples);
+
+    // Replaces left and right with the network's wet output. Lines read before they are
+    // written, so the input reaches the output after the shortest delay.
+    void (*reverbFrames)(const ReverbLines& lines, float* left, float* right, int numSamples);
+
+    // Replaces left and right with the delayed signal. The modulated delay must stay at
+    // least delayChunk + 2 samples, so every chunk's reads come before its writes.
+    void (*delayFrames)(const DelayLines& lines, float* left, float* right, int numSamples);
+
+    // Partitioned convolution, see ConvolutionReverb. Spectra are split: stride real parts,
+    // then stride imaginary parts. accumulator += x * h, bin by bin.
+    void (*multiplyAddSpectra)(float* accumulator, const float* x, const float* h, int stride);
+
+    // destination[i] = sum of taps[t] * source[i + t] over t < numTaps
+    void (*convolveDirect)(const float* taps, int numTaps, const float* source, float* destination, int numSamples);
+
+    // Drives samples in place through a first- or second-order ADAA waveshaper
+    void (*shaperSamples)(const ShaperChannel& channel, float* samples, int numSamples);
+
+    // Steps numLanes xorshift32 generators; numSamples must be a multiple of numLanes
+    void (*whiteNoise)(std::uint32_t* states, float* destination, int numSamples);
+
+    InstructionSet instructionSet;
+    const char* name;
+
+    // The widest variant this CPU supports, chosen on the first call
+    static const DspKernels& get();
+};
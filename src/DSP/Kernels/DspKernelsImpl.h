@@ -0,0 +1,1031 @@
+// DSP kernel bodies, included once per instruction set by the Kernels_*.cpp files.
+//
+// Each includer defines DSP_KERNELS_NAMESPACE, DSP_KERNELS_INSTRUCTION_SET and
+// DSP_KERNELS_NAME first. Everything below has internal linkage and calls no
+// inline functions from other headers (std::floor, std::abs, juce::jmax...):
+// a shared inline function compiled with AVX flags could otherwise be picked
+// by the linker for every caller, including the ones meant for older CPUs.
+// No #pragma once - including this twice in one file is a mistake anyway.
+
+#include "DspKernels.h"
+#include <cstring>
+
+namespace DSP_KERNELS_NAMESPACE
+{
+namespace
+{
+    constexpr int numLanes = DspKernels::numLanes;
+
+    //==============================================================================
+    // Branch-free helpers that vectorise on every target
+
+    inline float floorOf(float x)
+    {
+        const float truncated = (float) (int) x;
+        return truncated > x ? truncated - 1.0f : truncated;
+    }
+
+    inline float absOf(float x) { return x < 0.0f ? -x : x; }
+    inline float maxOf(float a, float b) { return a > b ? a : b; }
+    inline float minOf(float a, float b) { return a < b ? a : b; }
+
+    //==============================================================================
+    // Gain ramps
+
+    void accumulateRamp(float* destination, const float* source, float startGain, float gainStep, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] += source[i] * (startGain + gainStep * (float) i);
+    }
+
+    void accumulateRampPanned(float* left, float* right, const float* source,
+                              float startLeft, float stepLeft, float startRight, float stepRight, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = source[i];
+            left[i] += x * (startLeft + stepLeft * (float) i);
+            right[i] += x * (startRight + stepRight * (float) i);
+        }
+    }
+
+    //==============================================================================
+    // State-variable filters
+
+    void filterFrames(const DspKernels::FilterLanes& lanes, float* frames, int numSamples)
+    {
+        alignas(64) float gs[numLanes], ks[numLanes], gStep[numLanes], kStep[numLanes], ic1[numLanes], ic2[numLanes];
+
+        const float rampScale = 1.0f / (float) numSamples;
+        for (int l = 0; l < numLanes; ++l)
+        {
+            gs[l] = lanes.g[l];
+            ks[l] = lanes.k[l];
+            gStep[l] = (lanes.gTarget[l] - gs[l]) * rampScale;
+            kStep[l] = (lanes.kTarget[l] - ks[l]) * rampScale;
+            ic1[l] = lanes.s1[l];
+            ic2[l] = lanes.s2[l];
+        }
+
+        const float lowGain = lanes.lowGain;
+        const float bandGain = lanes.bandGain;
+        const float highGain = lanes.highGain;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* frame = frames + i * numLanes;
+
+            for (int l = 0; l < numLanes; ++l)
+            {
+                gs[l] += gStep[l];
+                ks[l] += kStep[l];
+
+                const float a1 = 1.0f / (1.0f + gs[l] * (gs[l] + ks[l]));
+                const float a2 = gs[l] * a1;
+                const float a3 = gs[l] * a2;
+
+                const float v0 = frame[l];
+                const float v3 = v0 - ic2[l];
+                const float v1 = a1 * ic1[l] + a2 * v3;
+                const float v2 = ic2[l] + a2 * ic1[l] + a3 * v3;
+                ic1[l] = 2.0f * v1 - ic1[l];
+                ic2[l] = 2.0f * v2 - ic2[l];
+
+                frame[l] = lowGain * v2 + bandGain * v1 + highGain * (v0 - ks[l] * v1 - v2);
+            }
+        }
+
+        for (int l = 0; l < numLanes; ++l)
+        {
+            // Land exactly on the targets so rounding in the ramp doesn't accumulate
+            lanes.g[l] = lanes.gTarget[l];
+            lanes.k[l] = lanes.kTarget[l];
+            lanes.s1[l] = ic1[l];
+            lanes.s2[l] = ic2[l];
+        }
+    }
+
+    //==============================================================================
+    // Ladder filters
+
+    // tan(x) for x in [0, pi/2), the same approximant as StateVariableFilterBank::fastTan
+    inline float tanOf(float x)
+    {
+        const float x2 = x * x;
+        const float numerator = x * (135135.0f - x2 * (17325.0f - x2 * (378.0f - x2)));
+        const float denominator = 135135.0f - x2 * (62370.0f - x2 * (3150.0f - 28.0f * x2));
+        return numerator / denominator;
+    }
+
+    // 2^x within 2e-6 relative, x clamped to [-24, 24]
+    inline float exp2Of(float x)
+    {
+        x = minOf(maxOf(x, -24.0f), 24.0f);
+        const float whole = floorOf(x);
+        const float f = x - whole;
+        const float p = 1.0f + f * (0.6931472f + f * (0.2402265f + f * (0.0555041f + f * (0.0096181f + f * 0.0013333f))));
+
+        const std::int32_t bits = ((std::int32_t) whole + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return p * scale;
+    }
+
+    // Rational tanh-like soft clip, slope 1 at zero and +-1 from +-3 on
+    inline float softClip(float x)
+    {
+        const float c = minOf(maxOf(x, -3.0f), 3.0f);
+        const float c2 = c * c;
+        return c * (27.0f + c2) / (27.0f + 9.0f * c2);
+    }
+
+    template <bool Modulated>
+    void ladderFrames(const DspKernels::LadderLanes& lanes, float* frames, int numSamples)
+    {
+        // Just below pi / 2, where tan blows up - about 0.45 * sampleRate
+        constexpr float maxCutoff = 1.4f;
+
+        alignas(64) float cutoffs[numLanes], cutoffStep[numLanes];
+        alignas(64) float s1[numLanes], s2[numLanes], s3[numLanes], s4[numLanes];
+
+        const float rampScale = 1.0f / (float) numSamples;
+        for (int l = 0; l < numLanes; ++l)
+        {
+            cutoffs[l] = lanes.cutoffs[l];
+            cutoffStep[l] = (lanes.cutoffTargets[l] - cutoffs[l]) * rampScale;
+            s1[l] = lanes.states[l];
+            s2[l] = lanes.states[numLanes + l];
+            s3[l] = lanes.states[2 * numLanes + l];
+            s4[l] = lanes.states[3 * numLanes + l];
+        }
+
+        const float k = lanes.feedback;
+        const float inputGain = lanes.inputGain;
+        const float depth = lanes.modulationDepth;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* frame = frames + i * numLanes;
+            const float* modulation = Modulated ? lanes.modulation + i * numLanes : nullptr;
+
+            for (int l = 0; l < numLanes; ++l)
+            {
+                cutoffs[l] += cutoffStep[l];
+
+                float w = cutoffs[l];
+                if constexpr (Modulated)
+                    w = minOf(w * exp2Of(depth * modulation[l]), maxCutoff);
+
+                // One TPT pole: y = G * x + (1 - G) * s
+                const float g = tanOf(w);
+                const float G = g / (1.0f + g);
+                const float H = 1.0f - G;
+
+                // Solve the loop linearly, then feed back the soft-clipped estimate of the last pole
+                const float sigma = H * (G * (G * (G * s1[l] + s2[l]) + s3[l]) + s4[l]);
+                const float G4 = (G * G) * (G * G);
+                const float x = frame[l] * inputGain;
+                const float u0 = (x - k * sigma) / (1.0f + k * G4);
+                const float u = x - k * softClip(G4 * u0 + sigma);
+
+                const float v1 = (u - s1[l]) * G;
+                const float y1 = v1 + s1[l];
+                s1[l] = y1 + v1;
+
+                const float v2 = (y1 - s2[l]) * G;
+                const float y2 = v2 + s2[l];
+                s2[l] = y2 + v2;
+
+                const float v3 = (y2 - s3[l]) * G;
+                const float y3 = v3 + s3[l];
+                s3[l] = y3 + v3;
+
+                const float v4 = (y3 - s4[l]) * G;
+                const float y4 = v4 + s4[l];
+                s4[l] = y4 + v4;
+
+                frame[l] = y4;
+            }
+        }
+
+        for (int l = 0; l < numLanes; ++l)
+        {
+            lanes.cutoffs[l] = lanes.cutoffTargets[l];
+            lanes.states[l] = s1[l];
+            lanes.states[numLanes + l] = s2[l];
+            lanes.states[2 * numLanes + l] = s3[l];
+            lanes.states[3 * numLanes + l] = s4[l];
+        }
+    }
+
+    void ladderFrames(const DspKernels::LadderLanes& lanes, float* frames, int numSamples)
+    {
+        if (lanes.modulation != nullptr)
+            ladderFrames<true>(lanes, frames, numSamples);
+        else
+            ladderFrames<false>(lanes, frames, numSamples);
+    }
+
+    //==============================================================================
+    // PolyBLEP oscillators
+
+    // Signed distance from phase t to an edge at edgePhase, wrapped to [-0.5, 0.5)
+    inline float edgeDistance(float t, float edgePhase)
+    {
+        const float d = t - edgePhase;
+        return d - floorOf(d + 0.5f);
+    }
+
+    // 2-point PolyBLEP residual for a downward step of 2 at distance d (in phase) from the edge
+    inline float polyBlep(float d, float dt)
+    {
+        const float x = d / dt;
+        const float w = maxOf(0.0f, 1.0f - absOf(x));
+        return x < 0.0f ? w * w : -w * w;
+    }
+
+    // PolyBLAMP residual (in samples) for a unit change of slope per sample
+    inline float polyBlamp(float d, float dt)
+    {
+        const float w = maxOf(0.0f, 1.0f - absOf(d / dt));
+        return w * w * w * (1.0f / 6.0f);
+    }
+
+    // sin(pi * v) for v in [-1, 1) - error below 1e-3, harmonics below -70 dB
+    inline float sinPi(float v)
+    {
+        const float v2 = v * v;
+        return 3.14159265f * v * (1.0f - v2) * (1.0f - 0.639595f * v2 + 0.139595f * v2 * v2);
+    }
+
+    // Waveform shapes over phase t in [0, 1), matching WaveTableBank's tables
+    inline float sawSample(float t, float dt)
+    {
+        return 2.0f * t - 1.0f - polyBlep(edgeDistance(t, 0.0f), dt);
+    }
+
+    inline float squareSample(float t, float dt)
+    {
+        const float naive = t < 0.5f ? -1.0f : 1.0f;
+        return naive - polyBlep(edgeDistance(t, 0.0f), dt) + polyBlep(edgeDistance(t, 0.5f), dt);
+    }
+
+    inline float triangleSample(float t, float dt)
+    {
+        // Falls from 0 to -1 at t = 0.25, rises to +1 at t = 0.75; slope changes by +-8 per cycle
+        const float naive = t < 0.25f ? -4.0f * t
+                          : t < 0.75f ? 4.0f * t - 2.0f
+                                      : 4.0f - 4.0f * t;
+        return naive + 8.0f * dt * (polyBlamp(edgeDistance(t, 0.25f), dt) - polyBlamp(edgeDistance(t, 0.75f), dt));
+    }
+
+    inline float sineSample(float t)
+    {
+        return sinPi(2.0f * t - 1.0f);
+    }
+
+    // Shape index values follow WaveTableBank::Waveform; "user" and beyond fall back to sine
+    void renderShape(int shape, const float* phases, const float* increments, float* output)
+    {
+        // Each loop body is branch-free per lane so all lanes run in one SIMD pass
+        switch (shape)
+        {
+            case 0:
+                for (int l = 0; l < numLanes; ++l)
+                    output[l] = sawSample(phases[l], increments[l]);
+                break;
+            case 1:
+                for (int l = 0; l < numLanes; ++l)
+                    output[l] = squareSample(phases[l], increments[l]);
+                break;
+            case 2:
+                for (int l = 0; l < numLanes; ++l)
+                    output[l] = triangleSample(phases[l], increments[l]);
+                break;
+            default:
+                for (int l = 0; l < numLanes; ++l)
+                    output[l] = sineSample(phases[l]);
+                break;
+        }
+    }
+
+    template <bool Stereo>
+    void polyBlepFrames(const DspKernels::PolyBlepLanes& lanes, float* leftFrames, float* rightFrames, int numSamples)
+    {
+        alignas(64) float phases[numLanes];
+        alignas(64) float current[numLanes];
+        alignas(64) float previous[numLanes];
+        alignas(64) float leftGains[numLanes];
+        alignas(64) float rightGains[numLanes];
+
+        for (int osc = 0; osc < lanes.numOscillators; ++osc)
+        {
+            float* rowPhases = lanes.phases + osc * numLanes;
+            const float* increments = lanes.increments + osc * numLanes;
+
+            for (int l = 0; l < numLanes; ++l)
+            {
+                phases[l] = rowPhases[l];
+                leftGains[l] = lanes.gains[l] * lanes.leftGains[osc];
+                rightGains[l] = Stereo ? lanes.gains[l] * lanes.rightGains[osc] : 0.0f;
+            }
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                renderShape(lanes.shape, phases, increments, current);
+
+                const float fade = lanes.startFade - lanes.fadeStep * (float) i;
+                if (fade > 0.0f)
+                {
+                    renderShape(lanes.previousShape, phases, increments, previous);
+                    for (int l = 0; l < numLanes; ++l)
+                        current[l] += (previous[l] - current[l]) * fade;
+                }
+
+                float* left = leftFrames + i * numLanes;
+                float* right = Stereo ? rightFrames + i * numLanes : nullptr;
+
+                for (int l = 0; l < numLanes; ++l)
+                {
+                    left[l] += current[l] * leftGains[l];
+                    if constexpr (Stereo)
+                        right[l] += current[l] * rightGains[l];
+
+                    const float p = phases[l] + increments[l];
+                    phases[l] = p - floorOf(p);
+                }
+            }
+
+            for (int l = 0; l < numLanes; ++l)
+                rowPhases[l] = phases[l];
+        }
+    }
+
+    void polyBlepFrames(const DspKernels::PolyBlepLanes& lanes, float* leftFrames, float* rightFrames, int numSamples)
+    {
+        if (rightFrames != nullptr)
+            polyBlepFrames<true>(lanes, leftFrames, rightFrames, numSamples);
+        else
+            polyBlepFrames<false>(lanes, leftFrames, nullptr, numSamples);
+    }
+
+    //==============================================================================
+    // Wavetable oscillators
+
+    template <bool Crossfade, bool Stereo>
+    void wavetableFrames(const DspKernels::WavetableLanes& lanes, float* leftFrames, float* rightFrames, int numSamples)
+    {
+        const float* table = lanes.table;
+        const float* previous = lanes.previousTable;
+        const float size = (float) lanes.tableSize;
+
+        alignas(64) float phases[numLanes];
+        alignas(64) float leftGains[numLanes];
+        alignas(64) float rightGains[numLanes];
+
+        for (int osc = 0; osc < lanes.numOscillators; ++osc)
+        {
+            float* rowPhases = lanes.phases + osc * numLanes;
+            const float* increments = lanes.increments + osc * numLanes;
+            const int* offsets = lanes.levelOffsets + osc * numLanes;
+
+            for (int l = 0; l < numLanes; ++l)
+            {
+                phases[l] = rowPhases[l];
+                leftGains[l] = lanes.gains[l] * lanes.leftGains[osc];
+                rightGains[l] = Stereo ? lanes.gains[l] * lanes.rightGains[osc] : 0.0f;
+            }
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float* left = leftFrames + i * numLanes;
+                float* right = Stereo ? rightFrames + i * numLanes : nullptr;
+                const float fade = Crossfade ? maxOf(0.0f, lanes.startFade - lanes.fadeStep * (float) i) : 0.0f;
+
+                // One voice per lane: only the two table reads per lane are gathers
+                for (int l = 0; l < numLanes; ++l)
+                {
+                    const float position = phases[l] * size;
+                    const int index = (int) position;
+                    const float frac = position - (float) index;
+                    const int at = offsets[l] + index;
+
+                    float sample = table[at] + (table[at + 1] - table[at]) * frac;
+                    if constexpr (Crossfade)
+                        sample += (previous[at] + (previous[at + 1] - previous[at]) * frac - sample) * fade;
+
+                    left[l] += sample * leftGains[l];
+                    if constexpr (Stereo)
+                        right[l] += sample * rightGains[l];
+
+                    const float next = phases[l] + increments[l];
+                    phases[l] = next - floorOf(next);
+                }
+            }
+
+            for (int l = 0; l < numLanes; ++l)
+                rowPhases[l] = phases[l];
+        }
+    }
+
+    void wavetableFrames(const DspKernels::WavetableLanes& lanes, float* leftFrames, float* rightFrames, int numSamples)
+    {
+        const bool crossfade = lanes.previousTable != nullptr && lanes.startFade > 0.0f;
+
+        if (rightFrames != nullptr)
+        {
+            if (crossfade) wavetableFrames<true, true>(lanes, leftFrames, rightFrames, numSamples);
+            else           wavetableFrames<false, true>(lanes, leftFrames, rightFrames, numSamples);
+        }
+        else
+        {
+            if (crossfade) wavetableFrames<true, false>(lanes, leftFrames, nullptr, numSamples);
+            else           wavetableFrames<false, false>(lanes, leftFrames, nullptr, numSamples);
+        }
+    }
+
+    //==============================================================================
+    // Envelopes
+
+    void envelopeFrames(float* levels, const float* coefficients, const float* offsets, float* frames, int numSamples)
+    {
+        alignas(64) float state[numLanes];
+        for (int l = 0; l < numLanes; ++l)
+            state[l] = levels[l];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* frame = frames + i * numLanes;
+            for (int l = 0; l < numLanes; ++l)
+            {
+                state[l] = state[l] * coefficients[l] + offsets[l];
+                frame[l] = state[l];
+            }
+        }
+
+        for (int l = 0; l < numLanes; ++l)
+            levels[l] = state[l];
+    }
+
+    //==============================================================================
+    // Reverb
+
+    constexpr int reverbLines = DspKernels::reverbLines;
+
+    // Unnormalised 16-point Hadamard transform, four butterfly stages
+    inline void hadamard(float* x)
+    {
+        for (int half = 1; half < reverbLines; half *= 2)
+        {
+            for (int start = 0; start < reverbLines; start += 2 * half)
+            {
+                for (int j = start; j < start + half; ++j)
+                {
+                    const float a = x[j];
+                    const float b = x[j + half];
+                    x[j] = a + b;
+                    x[j + half] = a - b;
+                }
+            }
+        }
+    }
+
+    void reverbFrames(const DspKernels::ReverbLines& lines, float* left, float* right, int numSamples)
+    {
+        alignas(64) float delays[reverbLines], delayStep[reverbLines];
+        alignas(64) float lfoCos[reverbLines], lfoSin[reverbLines];
+        alignas(64) float damping[reverbLines];
+        alignas(64) float outputs[reverbLines];
+
+        const float rampScale = 1.0f / (float) numSamples;
+        for (int l = 0; l < reverbLines; ++l)
+        {
+            delays[l] = lines.delays[l];
+            delayStep[l] = (lines.delayTargets[l] - delays[l]) * rampScale;
+            lfoCos[l] = lines.lfoCos[l];
+            lfoSin[l] = lines.lfoSin[l];
+            damping[l] = lines.damping[l];
+        }
+
+        float* memory = lines.memory;
+        const int mask = lines.mask;
+        const float depth = lines.modulationDepth;
+        const float coefficient = lines.dampingCoefficient;
+        const float mixScale = 0.25f; // Makes the Hadamard orthonormal
+        int position = *lines.position;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Read every line at its modulated delay, then damp and decay it
+            for (int l = 0; l < reverbLines; ++l)
+            {
+                delays[l] += delayStep[l];
+
+                const float read = (float) position - (delays[l] + depth * lfoSin[l]);
+                const float whole = floorOf(read);
+                const float frac = read - whole;
+                const int at = (int) whole;
+
+                const float a = memory[(at & mask) * reverbLines + l];
+                const float b = memory[((at + 1) & mask) * reverbLines + l];
+                const float y = a + (b - a) * frac;
+
+                damping[l] += (y - damping[l]) * coefficient;
+                outputs[l] = damping[l] * lines.gains[l];
+
+                const float c = lfoCos[l];
+                const float s = lfoSin[l];
+                lfoCos[l] = c * lines.lfoRotationCos[l] - s * lines.lfoRotationSin[l];
+                lfoSin[l] = s * lines.lfoRotationCos[l] + c * lines.lfoRotationSin[l];
+            }
+
+            // Even lines feed the left output, odd lines the right
+            float sumLeft = 0.0f;
+            float sumRight = 0.0f;
+            for (int l = 0; l < reverbLines; l += 2)
+            {
+                sumLeft += outputs[l];
+                sumRight += outputs[l + 1];
+            }
+
+            hadamard(outputs);
+
+            // Mixed lines plus the input - left into the even lines, right into the odd ones - go back in
+            const float inLeft = left[i] * lines.inputGain;
+            const float inRight = right[i] * lines.inputGain;
+            float* frame = memory + (position & mask) * reverbLines;
+            for (int l = 0; l < reverbLines; l += 2)
+            {
+                frame[l] = outputs[l] * mixScale + inLeft;
+                frame[l + 1] = outputs[l + 1] * mixScale + inRight;
+            }
+
+            left[i] = sumLeft * lines.outputGain;
+            right[i] = sumRight * lines.outputGain;
+            position = (position + 1) & mask;
+        }
+
+        for (int l = 0; l < reverbLines; ++l)
+        {
+            // Land exactly on the targets, and keep the phasors on the unit circle
+            lines.delays[l] = lines.delayTargets[l];
+
+            const float c = lfoCos[l];
+            const float s = lfoSin[l];
+            const float norm = 1.5f - 0.5f * (c * c + s * s); // One Newton step towards 1 / |phasor|
+            lines.lfoCos[l] = c * norm;
+            lines.lfoSin[l] = s * norm;
+            lines.damping[l] = damping[l];
+        }
+
+        *lines.position = position;
+    }
+
+    //==============================================================================
+    // Delay lines
+
+    constexpr int delayChunk = DspKernels::delayChunk;
+
+    // Catmull-Rom through four neighbouring samples, t in [0, 1) between b and c
+    inline float cubicOf(float a, float b, float c, float d, float t)
+    {
+        const float c1 = 0.5f * (c - a);
+        const float c2 = a - 2.5f * b + 2.0f * c - 0.5f * d;
+        const float c3 = 0.5f * (d - a) + 1.5f * (b - c);
+        return b + t * (c1 + t * (c2 + t * c3));
+    }
+
+    // One sine cycle per unit of t, for any t
+    inline float cycleOf(float t)
+    {
+        return sinPi(2.0f * (t - floorOf(t)) - 1.0f);
+    }
+
+    void delayFrames(const DspKernels::DelayLines& lines, float* left, float* right, int numSamples)
+    {
+        alignas(64) float wetLeft[delayChunk], wetRight[delayChunk];
+
+        const float* readLeft = lines.memoryLeft;
+        const float* readRight = lines.memoryRight;
+        const int mask = lines.mask;
+        const float straight = 1.0f - lines.pingPong;
+        const float cross = lines.pingPong;
+        const float coefficient = lines.toneCoefficient;
+        int position = *lines.position;
+        float wow = *lines.wowPhase;
+        float flutter = *lines.flutterPhase;
+        float toneLeft = lines.tone[0];
+        float toneRight = lines.tone[1];
+
+        for (int start = 0; start < numSamples; start += delayChunk)
+        {
+            const int n = numSamples - start < delayChunk ? numSamples - start : delayChunk;
+
+            // Every read lands before the chunk's first write, so this pass vectorises
+            for (int i = 0; i < n; ++i)
+            {
+                const float delay = lines.startDelay + lines.delayStep * (float) (start + i)
+                                  + lines.wowDepth * cycleOf(wow + lines.wowIncrement * (float) i)
+                                  + lines.flutterDepth * cycleOf(flutter + lines.flutterIncrement * (float) i);
+
+                const float read = (float) (position + i) - delay;
+                const float whole = floorOf(read);
+                const float frac = read - whole;
+                const int at = (int) whole;
+
+                const int a = (at - 1) & mask;
+                const int b = at & mask;
+                const int c = (at + 1) & mask;
+                const int d = (at + 2) & mask;
+                wetLeft[i] = cubicOf(readLeft[a], readLeft[b], readLeft[c], readLeft[d], frac);
+                wetRight[i] = cubicOf(readRight[a], readRight[b], readRight[c], readRight[d], frac);
+            }
+
+            // Each repeat is darkened and saturated with the input on the way back in, like tape.
+            // Ping-pong feeds the input to the left only and swaps the sides every repeat.
+            for (int i = 0; i < n; ++i)
+            {
+                const float yLeft = wetLeft[i];
+                const float yRight = wetRight[i];
+                toneLeft += (straight * yLeft + cross * yRight - toneLeft) * coefficient;
+                toneRight += (straight * yRight + cross * yLeft - toneRight) * coefficient;
+
+                const float inLeft = left[start + i];
+                const float inRight = right[start + i];
+                const int at = (position + i) & mask;
+                lines.memoryLeft[at] = softClip(straight * inLeft + cross * 0.5f * (inLeft + inRight) + toneLeft * lines.feedback);
+                lines.memoryRight[at] = softClip(straight * inRight + toneRight * lines.feedback);
+
+                left[start + i] = yLeft;
+                right[start + i] = yRight;
+            }
+
+            position = (position + n) & mask;
+            wow += lines.wowIncrement * (float) n;
+            wow -= floorOf(wow);
+            flutter += lines.flutterIncrement * (float) n;
+            flutter -= floorOf(flutter);
+        }
+
+        *lines.position = position;
+        *lines.wowPhase = wow;
+        *lines.flutterPhase = flutter;
+        lines.tone[0] = toneLeft;
+        lines.tone[1] = toneRight;
+    }
+
+    //==============================================================================
+    // Convolution
+
+    void multiplyAddSpectra(float* accumulator, const float* x, const float* h, int stride)
+    {
+        float* accumulatorIm = accumulator + stride;
+        const float* xIm = x + stride;
+        const float* hIm = h + stride;
+
+        for (int k = 0; k < stride; ++k)
+        {
+            accumulator[k] += x[k] * h[k] - xIm[k] * hIm[k];
+            accumulatorIm[k] += x[k] * hIm[k] + xIm[k] * h[k];
+        }
+    }
+
+    void convolveDirect(const float* taps, int numTaps, const float* source, float* destination, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float* x = source + i;
+            float sum = 0.0f;
+            for (int t = 0; t < numTaps; ++t)
+                sum += taps[t] * x[t];
+            destination[i] = sum;
+        }
+    }
+
+    //==============================================================================
+    // Waveshapers
+    //
+    // Antiderivative anti-aliasing shapes the difference quotients of a shaper's
+    // integrals, which cancel most of their digits, so this section runs in double
+    // precision and its approximations are accurate to a few ulp: an error step
+    // of 1e-7 would be amplified into audible noise by a small input step.
+
+    inline double floorOf(double x) // |x| < 2^31
+    {
+        const double truncated = (double) (std::int32_t) x;
+        return truncated > x ? truncated - 1.0 : truncated;
+    }
+
+    inline double absOf(double x) { return x < 0.0 ? -x : x; }
+    inline double signOf(double x) { return x < 0.0 ? -1.0 : 1.0; }
+
+    constexpr double ln2 = 0.69314718055994530942;
+    constexpr double piSquaredOver24 = 0.41123351671205660911;
+
+    // Input steps below this take the fallback instead of a difference quotient
+    constexpr double illConditioned = 1.0e-4;
+
+    // e^x for x in [-80, 0]
+    inline double expOf(double x)
+    {
+        x = x < -80.0 ? -80.0 : x;
+
+        // x = k ln2 + r with |r| <= ln2 / 2, ln2 split so the reduction is exact
+        const double k = floorOf(x * 1.4426950408889634 + 0.5);
+        const double r = (x - k * 6.93147180369123816490e-01) - k * 1.90821492927058770002e-10;
+
+        // Taylor series to r^13, the last term below 2e-16
+        double p = 1.0 / 6227020800.0;
+        p = p * r + 1.0 / 479001600.0;
+        p = p * r + 1.0 / 39916800.0;
+        p = p * r + 1.0 / 3628800.0;
+        p = p * r + 1.0 / 362880.0;
+        p = p * r + 1.0 / 40320.0;
+        p = p * r + 1.0 / 5040.0;
+        p = p * r + 1.0 / 720.0;
+        p = p * r + 1.0 / 120.0;
+        p = p * r + 1.0 / 24.0;
+        p = p * r + 1.0 / 6.0;
+        p = p * r + 0.5;
+        p = p * r + 1.0;
+        p = p * r + 1.0;
+
+        const std::int64_t bits = (std::int64_t) ((std::int32_t) k + 1023) << 52;
+        double scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return p * scale;
+    }
+
+    // log(1 + x) for x in [0, 1], as 2 atanh(x / (2 + x))
+    inline double log1pOf(double x)
+    {
+        const double s = x / (2.0 + x); // <= 1/3
+        const double z = s * s;
+
+        double p = 1.0 / 33.0;
+        for (int n = 31; n >= 1; n -= 2)
+            p = p * z + 1.0 / (double) n;
+
+        return 2.0 * s * p;
+    }
+
+    // Li2(1 - e^-u) for u in [0, ln2], the Bernoulli series of the dilogarithm
+    inline double dilogarithmOf(double u)
+    {
+        const double z = u * u;
+
+        double p = -1.9939295860721074e-14;
+        p = p * z + 8.921691020456452e-13;
+        p = p * z - 4.0647616451442256e-11;
+        p = p * z + 1.8978869988971e-09;
+        p = p * z - 9.185773074661964e-08;
+        p = p * z + 4.72411186696901e-06;
+        p = p * z - 1.0 / 3600.0;
+        p = p * z + 1.0 / 36.0;
+        p = p * z + 1.0;
+
+        return u * p - 0.25 * z;
+    }
+
+    // Each shaper: value f, first integral F1 (F1' = f) and second integral F2 (F2' = F1)
+    struct TanhShaper
+    {
+        static double value(double x)
+        {
+            const double e = expOf(-2.0 * absOf(x));
+            return signOf(x) * (1.0 - e) / (1.0 + e);
+        }
+
+        // log cosh x = |x| - ln2 + log(1 + e^-2|x|)
+        static double firstIntegral(double x)
+        {
+            const double a = absOf(x);
+            return a - ln2 + log1pOf(expOf(-2.0 * a));
+        }
+
+        // Integral of log cosh from 0: with L = log(1 + e^-2|x|), Landen's identity gives
+        // Li2(-e^-2|x|) = -Li2(1 - e^-L) - L^2 / 2
+        static double secondIntegral(double x)
+        {
+            const double a = absOf(x);
+            const double L = log1pOf(expOf(-2.0 * a));
+            return signOf(x) * (0.5 * a * a - ln2 * a - 0.5 * dilogarithmOf(L) - 0.25 * L * L + piSquaredOver24);
+        }
+    };
+
+    struct HardClipShaper
+    {
+        static double value(double x) { return x < -1.0 ? -1.0 : (x > 1.0 ? 1.0 : x); }
+
+        static double firstIntegral(double x)
+        {
+            const double a = absOf(x);
+            return a <= 1.0 ? 0.5 * x * x : a - 0.5;
+        }
+
+        static double secondIntegral(double x)
+        {
+            const double a = absOf(x);
+            return signOf(x) * (a <= 1.0 ? a * a * a * (1.0 / 6.0) : 0.5 * a * a - 0.5 * a + 1.0 / 6.0);
+        }
+    };
+
+    // Triangle fold with period 4: slope 1 through zero, folding back at +-1
+    struct FoldbackShaper
+    {
+        // Position in the fold's period, 0 - 4, with x = 0 at 1
+        static double phaseOf(double x)
+        {
+            const double p = x + 1.0;
+            return p - 4.0 * floorOf(p * 0.25);
+        }
+
+        static double value(double x)
+        {
+            const double p = phaseOf(x);
+            return 1.0 - absOf(p - 2.0);
+        }
+
+        // Periodic with mean 1/2
+        static double firstIntegral(double x)
+        {
+            const double p = phaseOf(x);
+            return (p <= 2.0 ? 0.5 * p * p - p : -0.5 * p * p + 3.0 * p - 4.0) + 0.5;
+        }
+
+        // The periodic part of the first integral's integral, plus the mean's ramp
+        static double secondIntegral(double x)
+        {
+            const double p = phaseOf(x);
+            const double p2 = p * p;
+            const double periodic = p <= 2.0 ? p2 * p * (1.0 / 6.0) - 0.5 * p2
+                                             : -p2 * p * (1.0 / 6.0) + 1.5 * p2 - 4.0 * p + 8.0 / 3.0;
+            return periodic + 0.5 * x;
+        }
+    };
+
+    template <typename Shaper, int Order>
+    void shaperSamples(const DspKernels::ShaperChannel& channel, float* samples, int numSamples)
+    {
+        constexpr int chunkSize = 64;
+
+        // Driven inputs of the chunk, after the two before it; integrals and quotients alongside
+        alignas(64) double x[chunkSize + 2];
+        alignas(64) double integrals[chunkSize + 2];
+        alignas(64) double quotients[chunkSize + 2];
+        alignas(64) double shaped[chunkSize];
+
+        double previous = channel.history[0];
+        double older = channel.history[1];
+
+        for (int offset = 0; offset < numSamples; offset += chunkSize)
+        {
+            const int n = numSamples - offset < chunkSize ? numSamples - offset : chunkSize;
+
+            x[0] = older;
+            x[1] = previous;
+            for (int i = 0; i < n; ++i)
+                x[i + 2] = (double) (samples[offset + i] * (channel.startGain + channel.gainStep * (float) (offset + i)));
+
+            if constexpr (Order == 1)
+            {
+                // y[n] = (F1(x[n]) - F1(x[n - 1])) / (x[n] - x[n - 1])
+                for (int j = 1; j < n + 2; ++j)
+                    integrals[j] = Shaper::firstIntegral(x[j]);
+
+                for (int i = 0; i < n; ++i)
+                {
+                    const double step = x[i + 2] - x[i + 1];
+                    const double divisor = absOf(step) < illConditioned ? 1.0 : step;
+                    shaped[i] = (integrals[i + 2] - integrals[i + 1]) / divisor;
+                }
+
+                // Rare on audio: a step too small to divide by is shaped at its midpoint
+                for (int i = 0; i < n; ++i)
+                    if (absOf(x[i + 2] - x[i + 1]) < illConditioned)
+                        shaped[i] = Shaper::value(0.5 * (x[i + 2] + x[i + 1]));
+            }
+            else
+            {
+                // y[n] = 2 / (x[n] - x[n - 2]) * (D[n] - D[n - 1]),
+                // D[n] = (F2(x[n]) - F2(x[n - 1])) / (x[n] - x[n - 1])
+                for (int j = 0; j < n + 2; ++j)
+                    integrals[j] = Shaper::secondIntegral(x[j]);
+
+                for (int j = 1; j < n + 2; ++j)
+                {
+                    const double step = x[j] - x[j - 1];
+                    const double divisor = absOf(step) < illConditioned ? 1.0 : step;
+                    quotients[j] = (integrals[j] - integrals[j - 1]) / divisor;
+                }
+
+                for (int j = 1; j < n + 2; ++j)
+                    if (absOf(x[j] - x[j - 1]) < illConditioned)
+                        quotients[j] = Shaper::firstIntegral(0.5 * (x[j] + x[j - 1]));
+
+                for (int i = 0; i < n; ++i)
+                {
+                    const double span = x[i + 2] - x[i];
+                    const double divisor = absOf(span) < illConditioned ? 1.0 : span;
+                    shaped[i] = 2.0 * (quotients[i + 2] - quotients[i + 1]) / divisor;
+                }
+
+                // x[n] close to x[n - 2]: expand around their mean instead
+                for (int i = 0; i < n; ++i)
+                {
+                    if (absOf(x[i + 2] - x[i]) >= illConditioned)
+                        continue;
+
+                    const double mean = 0.5 * (x[i + 2] + x[i]);
+                    const double delta = mean - x[i + 1];
+
+                    shaped[i] = absOf(delta) < illConditioned
+                                    ? Shaper::value(0.5 * (mean + x[i + 1]))
+                                    : 2.0 / delta * (Shaper::firstIntegral(mean)
+                                                     + (integrals[i + 1] - Shaper::secondIntegral(mean)) / delta);
+                }
+            }
+
+            for (int i = 0; i < n; ++i)
+                samples[offset + i] = (float) shaped[i] * (channel.startLevel + channel.levelStep * (float) (offset + i));
+
+            older = x[n];
+            previous = x[n + 1];
+        }
+
+        channel.history[0] = previous;
+        channel.history[1] = older;
+    }
+
+    template <typename Shaper>
+    void shaperSamples(const DspKernels::ShaperChannel& channel, float* samples, int numSamples)
+    {
+        if (channel.order == 2)
+            shaperSamples<Shaper, 2>(channel, samples, numSamples);
+        else
+            shaperSamples<Shaper, 1>(channel, samples, numSamples);
+    }
+
+    void shaperSamples(const DspKernels::ShaperChannel& channel, float* samples, int numSamples)
+    {
+        switch (channel.shape)
+        {
+            case 1:  shaperSamples<HardClipShaper>(channel, samples, numSamples); break;
+            case 2:  shaperSamples<FoldbackShaper>(channel, samples, numSamples); break;
+            default: shaperSamples<TanhShaper>(channel, samples, numSamples); break;
+        }
+    }
+
+    //==============================================================================
+    // Noise
+
+    void whiteNoise(std::uint32_t* states, float* destination, int numSamples)
+    {
+        alignas(64) std::uint32_t state[numLanes];
+        std::memcpy(state, states, sizeof(state));
+
+        for (int i = 0; i < numSamples; i += numLanes)
+        {
+            for (int l = 0; l < numLanes; ++l)
+            {
+                std::uint32_t s = state[l];
+                s ^= s << 13;
+                s ^= s >> 17;
+                s ^= s << 5;
+                state[l] = s;
+
+                // Top 23 bits as the mantissa of a float in [1, 2), mapped to [-1, 1)
+                const std::uint32_t bits = (s >> 9) | 0x3f800000u;
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                destination[i + l] = value * 2.0f - 3.0f;
+            }
+        }
+
+        std::memcpy(states, state, sizeof(state));
+    }
+}
+
+const DspKernels& getKernels()
+{
+    static constexpr DspKernels kernels {
+        accumulateRamp,
+        accumulateRampPanned,
+        filterFrames,
+        ladderFrames,
+        polyBlepFrames,
+        wavetableFrames,
+        envelopeFrames,
+        reverbFrames,
+        delayFrames,
+        multiplyAddSpectra,
+        convolveDirect,
+        shaperSamples,
+        whiteNoise,
+        DspKernels::InstructionSet::DSP_KERNELS_INSTRUCTION_SET,
+        DSP_KERNELS_NAME
+    };
+
+    return kernels;
+}
+}
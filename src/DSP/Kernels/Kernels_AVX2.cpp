@@ -0,0 +1,9 @@
+// AVX2 + FMA kernels - CMakeLists.txt adds the target flags for this file only
+#include "DspKernels.h"
+
+#if VOID_KERNELS_X86
+ #define DSP_KERNELS_NAMESPACE DspKernelsAvx2
+ #define DSP_KERNELS_INSTRUCTION_SET avx2
+ #define DSP_KERNELS_NAME "AVX2"
+ #include "DspKernelsImpl.h"
+#endif
@@ -0,0 +1,9 @@
+// AVX-512 (F, VL, DQ, BW) kernels - CMakeLists.txt adds the target flags for this file only
+#include "DspKernels.h"
+
+#if VOID_KERNELS_X86
+ #define DSP_KERNELS_NAMESPACE DspKernelsAvx512
+ #define DSP_KERNELS_INSTRUCTION_SET avx512
+ #define DSP_KERNELS_NAME "AVX-512"
+ #include "DspKernelsImpl.h"
+#endif
@@ -0,0 +1,18 @@
+// Baseline kernels, built with the project's default target flags:
+// SSE2 on x86-64, NEON on arm64. Every supported CPU can run these.
+#include "DspKernels.h"
+
+#define DSP_KERNELS_NAMESPACE DspKernelsBaseline
+
+#if VOID_KERNELS_X86
+ #define DSP_KERNELS_INSTRUCTION_SET sse2
+ #define DSP_KERNELS_NAME "SSE2"
+#elif defined(__aarch64__) || defined(_M_ARM64)
+ #define DSP_KERNELS_INSTRUCTION_SET neon
+ #define DSP_KERNELS_NAME "NEON"
+#else
+ #define DSP_KERNELS_INSTRUCTION_SET generic
+ #define DSP_KERNELS_NAME "Generic"
+#endif
+
+#include "DspKernelsImpl.h"
@@ -0,0 +1,116 @@
+#include "LayerMixer.h"
+#include "Kernels/DspKernels.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cmath>
+
+namespace
+{
+    // sqrt(2) * cos/sin of the pan angle, built once at load time
+    struct PanTable
+    {
+        static constexpr int size = 128;
+
+        std::array<float, size + 1> left;
+        std::array<float, size + 1> right;
+
+        PanTable()
+        {
+            for (int i = 0; i <= size; ++i)
+            {
+                const float angle = juce::MathConstants<float>::halfPi * (float) i / (float) size;
+                left[(size_t) i] = juce::MathConstants<float>::sqrt2 * std::cos(angle);
+                right[(size_t) i] = juce::MathConstants<float>::sqrt2 * std::sin(angle);
+            }
+
+            // Exact unity at centre and exact silence at the extremes
+            left[size / 2] = right[size / 2] = 1.0f;
+            left[size] = right[0] = 0.0f;
+        }
+
+        static float lookup(const std::array<float, size + 1>& table, float pan)
+        {
+            const float position = (juce::jlimit(-1.0f, 1.0f, pan) + 1.0f) * 0.5f * (float) size;
+            const int index = juce::jmin((int) position, size - 1);
+            const float frac = position - (float) index;
+            return table[(size_t) index] + (table[(size_t) index + 1] - table[(size_t) index]) * frac;
+        }
+    };
+
+    const PanTable panTable;
+}
+
+float LayerMixer::getLeftPanGain(float pan)  { return PanTable::lookup(panTable.left, pan); }
+float LayerMixer::getRightPanGain(float pan) { return PanTable::lookup(panTable.right, pan); }
+
+void LayerMixer::setGain(int input, float level, float pan)
+{
+    jassert(juce::isPositiveAndBelow(input, maxInputs));
+
+    auto& gains = target[(size_t) input];
+    gains.left = level * getLeftPanGain(pan);
+    gains.right = level * getRightPanGain(pan);
+    gains.mono = level;
+}
+
+void LayerMixer::reset()
+{
+    current = target;
+}
+
+void LayerMixer::process(const Input* inputs, int numInputs, float* left, float* right, int numSamples)
+{
+    jassert(numInputs <= maxInputs);
+
+    if (numSamples <= 0)
+        return;
+
+    alignas(32) float tileLeft[tileSize];
+    alignas(32) float tileRight[tileSize];
+    const auto& kernels = DspKernels::get();
+    const float rampScale = 1.0f / (float) numSamples;
+
+    for (int offset = 0; offset < numSamples; offset += tileSize)
+    {
+        const int n = juce::jmin(tileSize, numSamples - offset);
+        std::fill(tileLeft, tileLeft + n, 0.0f);
+        std::fill(tileRight, tileRight + n, 0.0f);
+
+        for (int in = 0; in < numInputs; ++in)
+        {
+            const auto& input = inputs[in];
+            if (input.left == nullptr)
+                continue;
+
+            const auto& from = current[(size_t) in];
+            const auto& to = target[(size_t) in];
+
+            if (right == nullptr)
+            {
+                const float step = (to.mono - from.mono) * rampScale;
+                kernels.accumulateRamp(tileLeft, input.left + offset, from.mono + step * (float) offset, step, n);
+                continue;
+            }
+
+            const float stepLeft = (to.left - from.left) * rampScale;
+            const float stepRight = (to.right - from.right) * rampScale;
+            const float startLeft = from.left + stepLeft * (float) offset;
+            const float startRight = from.right + stepRight * (float) offset;
+
+            if (input.stereo)
+            {
+                kernels.accumulateRamp(tileLeft, input.left + offset, startLeft, stepLeft, n);
+                kernels.accumulateRamp(tileRight, input.right + offset, startRight, stepRight, n);
+            }
+            else
+            {
+                kernels.accumulateRampPanned(tileLeft, tileRight, input.left + offset, startLeft, stepLeft, startRight, stepRight, n);
+            }
+        }
+
+        juce::FloatVectorOperations::add(left + offset, tileLeft, n);
+        if (right != nullptr)
+            juce::FloatVectorOperations::add(right + offset, tileRight, n);
+    }
+
+    current = target;
+}
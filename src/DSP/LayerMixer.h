@@ -0,0 +1,55 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+
+/**
+ * LayerMixer - Fused level/pan stage for the engine's layer buses.
+ *
+ * Every input is mixed into the output in one pass: inputs are accumulated
+ * into a small on-stack tile, and the tile is added to the output once, so
+ * the output buffer is read and written a single time however many layers
+ * are enabled.
+ *
+ * Pan uses a constant-power law (L^2 + R^2 constant) looked up from a
+ * precomputed table and scaled so the centre position is unity gain. When a
+ * level or pan changes, the gains ramp linearly to the new values across the
+ * next processed block instead of stepping. The ramps run in DspKernels.
+ */
+class LayerMixer
+{
+public:
+    static constexpr int maxInputs = 4;
+
+    struct Input
+    {
+        const float* left = nullptr;  // nullptr = input not playing this block
+        const float* right = nullptr; // Only read when stereo is true
+        bool stereo = false;          // Mono inputs are read once and panned to both sides
+    };
+
+    // Target gains for one input; reached by the end of the next process() call
+    void setGain(int input, float level, float pan);
+
+    // Jumps every gain straight to its target
+    void reset();
+
+    // Adds inputs[0..numInputs) into left/right; right may be nullptr for a mono output
+    void process(const Input* inputs, int numInputs, float* left, float* right, int numSamples);
+
+    // Constant-power pan gains for pan in [-1, 1], 1.0 at centre
+    static float getLeftPanGain(float pan);
+    static float getRightPanGain(float pan);
+
+private:
+    static constexpr int tileSize = 64;
+
+    struct Gains
+    {
+        float left = 0.0f;
+        float right = 0.0f;
+        float mono = 0.0f;
+    };
+
+    std::array<Gains, maxInputs> current;
+    std::array<Gains, maxInputs> target;
+};
@@ -0,0 +1,125 @@
+#include "NoiseGenerator.h"
+#include <numeric>
+
+namespace
+{
+    // splitmix32 - spreads consecutive seeds into well-mixed, non-zero lane states
+    juce::uint32 mixSeed(juce::uint32 x)
+    {
+        x += 0x9e3779b9u;
+        x = (x ^ (x >> 16)) * 0x85ebca6bu;
+        x = (x ^ (x >> 13)) * 0xc2b2ae35u;
+        x ^= x >> 16;
+        return x != 0 ? x : 0x6d2b79f5u;
+    }
+
+    // Each instance draws a distinct seed so voices and plugin instances decorrelate
+    juce::uint32 nextInstanceSeed()
+    {
+        static std::atomic<juce::uint32> counter { 0x1234567u };
+        return counter.fetch_add(0x632be5abu, std::memory_order_relaxed);
+    }
+
+    // Output scaling measured so every colour has roughly the RMS of the old generators
+    constexpr float pinkScale = 0.094f;
+    constexpr float brownScale = 3.5f;
+    constexpr float blueScale = 2.15f;
+}
+
+NoiseGenerator::NoiseGenerator()
+    : seed(nextInstanceSeed())
+{
+    reset();
+}
+
+void NoiseGenerator::reset()
+{
+    juce::uint32 s = seed;
+    for (auto& lane : lanes)
+        lane = s = mixSeed(s);
+
+    pinkRows.fill(0.0f);
+    pinkSum = 0.0f;
+    pinkCounter = 0;
+    brownState = 0.0f;
+    lastPink = 0.0f;
+}
+
+void NoiseGenerator::process(float* destination, int numSamples)
+{
+    const int currentType = type.load(std::memory_order_relaxed);
+
+    alignas(32) float whiteSamples[chunkSize];
+    alignas(32) float rowSamples[chunkSize];
+
+    for (int offset = 0; offset < numSamples; offset += chunkSize)
+    {
+        const int n = juce::jmin(chunkSize, numSamples - offset);
+        const int nLanes = (n + numLanes - 1) / numLanes * numLanes;
+        float* out = destination + offset;
+
+        generateWhite(whiteSamples, nLanes);
+
+        switch (currentType)
+        {
+            case white:
+                std::copy(whiteSamples, whiteSamples + n, out);
+                break;
+
+            case brown:
+                for (int i = 0; i < n; ++i)
+                {
+                    brownState = (brownState + 0.02f * whiteSamples[i]) * (1.0f / 1.02f);
+                    out[i] = juce::jlimit(-1.0f, 1.0f, brownState * brownScale);
+                }
+                break;
+
+            case blue:
+                generateWhite(rowSamples, nLanes);
+                renderPink(out, whiteSamples, rowSamples, n);
+
+                // Differentiating pink tilts the spectrum from -3 dB to +3 dB per octave
+                for (int i = 0; i < n; ++i)
+                {
+                    const float current = out[i];
+                    out[i] = (current - lastPink) * blueScale;
+                    lastPink = current;
+                }
+                break;
+
+            case pink:
+            default:
+                generateWhite(rowSamples, nLanes);
+                renderPink(out, whiteSamples, rowSamples, n);
+                break;
+        }
+    }
+}
+
+void NoiseGenerator::generateWhite(float* destination, int numSamples)
+{
+    jassert(numSamples % numLanes == 0);
+    DspKernels::get().whiteNoise(lanes.data(), destination, numSamples);
+}
+
+void NoiseGenerator::renderPink(float* destination, const float* whiteSamples, const float* rowSamples, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Row k is redrawn every 2^(k+1) samples; the running sum avoids re-adding all rows
+        pinkCounter = (pinkCounter + 1) & ((1u << numPinkRows) - 1);
+        if (pinkCounter != 0)
+        {
+            const int row = std::countr_zero(pinkCounter);
+            pinkSum += rowSamples[i] - pinkRows[(size_t) row];
+            pinkRows[(size_t) row] = rowSamples[i];
+        }
+        else
+        {
+            // Resum once per cycle so rounding in the running sum can't drift
+            pinkSum = std::accumulate(pinkRows.begin(), pinkRows.end(), 0.0f);
+        }
+
+        destination[i] = (pinkSum + whiteSamples[i]) * pinkScale;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include "Kernels/DspKernels.h"
+
+/**
+ * NoiseGenerator - Block noise source with white, pink, brown and blue colours.
+ *
+ * White noise comes from eight interleaved xorshift32 generators stepped
+ * together (DspKernels::whiteNoise), so the core is plain shifts and xors
+ * the compiler runs as SIMD.
+ * Pink uses the Voss-McCartney row sum; brown is a leaky integrator of white
+ * and blue a first difference of pink. All state is per instance, and each
+ * instance gets its own seed so voices never play identical noise.
+ *
+ * The colour is an atomic: setType() may be called from any thread, and
+ * process() reads it once per block without locking.
+ */
+class NoiseGenerator
+{
+public:
+    // Matches the "noiseType" parameter choices
+    enum Type
+    {
+        white = 0,
+        pink,
+        brown,
+        blue
+    };
+
+    NoiseGenerator();
+
+    void setType(int newType) { type.store(newType, std::memory_order_relaxed); }
+    int getType() const { return type.load(std::memory_order_relaxed); }
+
+    void reset();
+
+    // Writes numSamples of noise in [-1, 1] to destination
+    void process(float* destination, int numSamples);
+
+private:
+    static constexpr int numLanes = DspKernels::numLanes;
+    static constexpr int chunkSize = 64;
+    static constexpr int numPinkRows = 12; // Lowest row updates every 4096 samples
+
+    std::atomic<int> type { pink };
+
+    alignas(32) std::array<juce::uint32, numLanes> lanes {};
+    juce::uint32 seed = 0;
+
+    // Voss-McCartney state
+    std::array<float, numPinkRows> pinkRows {};
+    float pinkSum = 0.0f;
+    juce::uint32 pinkCounter = 0;
+
+    float brownState = 0.0f;
+    float lastPink = 0.0f;
+
+    // Fills destination with numSamples (a multiple of numLanes) white samples
+    void generateWhite(float* destination, int numSamples);
+
+    void renderPink(float* destination, const float* whiteSamples, const float* rowSamples, int numSamples);
+};
@@ -0,0 +1,64 @@
+#include "Oversampler.h"
+
+void Oversampler::prepare(int numChannels, int maxBlockSize)
+{
+    maximumLatency = 0;
+
+    for (int q = 0; q < numQualities; ++q)
+    {
+        const auto filterType = q == (int) Quality::polyphaseIIR
+                                    ? juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR
+                                    : juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple;
+
+        for (int f = 0; f < numFactors; ++f)
+        {
+            // Stage f oversamples by 2^(f + 1); integer latency so a plain delay can match it
+            auto& stage = stages[(size_t) q][(size_t) f];
+            stage = std::make_unique<juce::dsp::Oversampling<float>>((size_t) numChannels, (size_t) (f + 1),
+                                                                      filterType, true, true);
+            stage->initProcessing((size_t) maxBlockSize);
+
+            maximumLatency = juce::jmax(maximumLatency, (int) std::lround(stage->getLatencyInSamples()));
+        }
+    }
+
+    selectStage();
+}
+
+void Oversampler::reset()
+{
+    if (current != nullptr)
+        current->reset();
+}
+
+void Oversampler::setFactor(int newFactor)
+{
+    newFactor = newFactor >= 8 ? 8 : newFactor >= 4 ? 4 : newFactor >= 2 ? 2 : 1;
+    if (newFactor == factor)
+        return;
+
+    factor = newFactor;
+    selectStage();
+}
+
+void Oversampler::setQuality(Quality newQuality)
+{
+    if (newQuality == quality)
+        return;
+
+    quality = newQuality;
+    selectStage();
+}
+
+int Oversampler::getLatencyInSamples() const
+{
+    return current != nullptr ? (int) std::lround(current->getLatencyInSamples()) : 0;
+}
+
+void Oversampler::selectStage()
+{
+    // The filters of a stage that sat unused hold stale history, so start it clean
+    const int index = factor == 8 ? 2 : factor == 4 ? 1 : factor == 2 ? 0 : -1;
+    current = index >= 0 ? stages[(size_t) quality][(size_t) index].get() : nullptr;
+    reset();
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <memory>
+
+/**
+ * Oversampler - Runs one nonlinear stage at 1x, 2x, 4x or 8x the host rate.
+ *
+ * Built on juce::dsp::Oversampling's cascaded half-band filters. Each stage that
+ * saturates, folds or clips owns one, so only that stage pays for the higher
+ * rate; the engine itself always runs at the host rate.
+ *
+ * Every factor and filter quality is built in prepare(), so changing either
+ * while playing is a pointer swap plus a filter reset - no allocation on the
+ * audio thread. Latency is rounded to whole samples (useIntegerLatency), which
+ * lets the owner delay its dry path to match and report the total to the host.
+ *
+ * process() upsamples a block, hands the oversampled block to the stage and
+ * filters it back down in place. At 1x the stage runs on the block directly.
+ */
+class Oversampler
+{
+public:
+    static constexpr int maxFactor = 8;
+
+    enum class Quality
+    {
+        polyphaseIIR = 0, // Low latency, not phase-linear near the band edge
+        linearPhaseFIR    // Equiripple half-bands, phase-linear but several times the latency
+    };
+
+    // Builds every factor and quality for blocks of up to maxBlockSize host samples (message thread)
+    void prepare(int numChannels, int maxBlockSize);
+    void reset();
+
+    // factor is rounded down to 1, 2, 4 or 8. The newly selected filters start from silence.
+    void setFactor(int newFactor);
+    void setQuality(Quality newQuality);
+
+    int getFactor() const { return factor; }
+    Quality getQuality() const { return quality; }
+
+    // Latency of the current setting, in host samples
+    int getLatencyInSamples() const;
+
+    // Latency of the slowest setting, so owners can size their dry delays once
+    int getMaximumLatencyInSamples() const { return maximumLatency; }
+
+    // Runs stage(juce::dsp::AudioBlock<float>&) on block at the current factor, in place
+    template <typename Stage>
+    void process(juce::dsp::AudioBlock<float>& block, Stage&& stage)
+    {
+        if (current == nullptr)
+        {
+            stage(block);
+            return;
+        }
+
+        auto oversampled = current->processSamplesUp(block);
+        stage(oversampled);
+        current->processSamplesDown(block);
+    }
+
+private:
+    static constexpr int numFactors = 3; // 2x, 4x, 8x - 1x needs no filters
+    static constexpr int numQualities = 2;
+
+    using Stages = std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, numFactors>;
+    std::array<Stages, numQualities> stages;
+
+    juce::dsp::Oversampling<float>* current = nullptr; // nullptr at 1x
+    int factor = 1;
+    Quality quality = Quality::polyphaseIIR;
+    int maximumLatency = 0;
+
+    void selectStage();
+};
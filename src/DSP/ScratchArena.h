@@ -0,0 +1,47 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * ScratchArena - Preallocated working memory for the audio thread.
+ *
+ * All temporary buffers used while rendering (layer buffers, mix buffers) are
+ * carved out of one block of channels sized in prepareToPlay, so the render
+ * path never touches the heap. Views are plain juce::AudioBuffers that refer
+ * to the arena's memory; constructing one does not allocate.
+ */
+class ScratchArena
+{
+public:
+    // Call from prepareToPlay only - this is the one place the arena allocates
+    void prepare(int numChannels, int maximumBlockSize)
+    {
+        storage.setSize(numChannels, maximumBlockSize, false, true, false);
+        storage.clear();
+    }
+
+    void release() { storage.setSize(0, 0); }
+
+    int getNumChannels() const { return storage.getNumChannels(); }
+    int getMaximumBlockSize() const { return storage.getNumSamples(); }
+
+    float* getChannel(int channel)
+    {
+        jassert(juce::isPositiveAndBelow(channel, storage.getNumChannels()));
+        return storage.getWritePointer(channel);
+    }
+
+    // All channel pointers at once. Resolve these before handing the arena to
+    // other threads - AudioBuffer's accessors update its state.
+    float* const* getChannels() { return storage.getArrayOfWritePointers(); }
+
+    // Returns a buffer referring to numChannels arena channels starting at firstChannel
+    juce::AudioBuffer<float> getView(int firstChannel, int numChannels, int numSamples)
+    {
+        jassert(firstChannel + numChannels <= storage.getNumChannels());
+        jassert(numSamples <= storage.getNumSamples());
+        return juce::AudioBuffer<float>(storage.getArrayOfWritePointers() + firstChannel, numChannels, numSamples);
+    }
+
+private:
+    juce::AudioBuffer<float> storage;
+};
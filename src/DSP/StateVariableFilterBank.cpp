@@ -0,0 +1,204 @@
+#include "StateVariableFilterBank.h"
+#include <juce_dsp/juce_dsp.h>
+#include <cmath>
+
+void StateVariableFilterBank::prepare(double newSampleRate, int newNumLanes)
+{
+    jassert(newNumLanes > 0 && newNumLanes <= maxLanes);
+
+    sampleRate = newSampleRate;
+    numLanes = juce::jlimit(1, maxLanes, newNumLanes);
+
+    for (int lane = 0; lane < maxLanes; ++lane)
+    {
+        if (cutoffs[(size_t) lane] <= 0.0f)
+            cutoffs[(size_t) lane] = 1000.0f;
+        if (kTarget[(size_t) lane] <= 0.0f)
+            kTarget[(size_t) lane] = juce::MathConstants<float>::sqrt2; // JUCE's default resonance of 1/sqrt(2)
+
+        setCutoffFrequency(lane, cutoffs[(size_t) lane]);
+    }
+
+    reset();
+}
+
+void StateVariableFilterBank::reset()
+{
+    // Start from the targets so the first block doesn't glide in from stale values
+    g = gTarget;
+    k = kTarget;
+    s1.fill(0.0f);
+    s2.fill(0.0f);
+}
+
+void StateVariableFilterBank::setType(Type newType)
+{
+    type = newType;
+}
+
+void StateVariableFilterBank::setCutoffFrequency(int lane, float frequency)
+{
+    jassert(juce::isPositiveAndBelow(lane, maxLanes));
+
+    const float limited = juce::jlimit(1.0f, (float) (sampleRate * 0.49), frequency);
+    cutoffs[(size_t) lane] = limited;
+    gTarget[(size_t) lane] = fastTan(juce::MathConstants<float>::pi * limited / (float) sampleRate);
+}
+
+void StateVariableFilterBank::setResonance(int lane, float resonance)
+{
+    jassert(juce::isPositiveAndBelow(lane, maxLanes));
+    jassert(resonance > 0.0f);
+
+    kTarget[(size_t) lane] = 1.0f / juce::jmax(1.0e-3f, resonance);
+}
+
+void StateVariableFilterBank::setCutoffFrequency(float frequency)
+{
+    for (int lane = 0; lane < numLanes; ++lane)
+        setCutoffFrequency(lane, frequency);
+}
+
+void StateVariableFilterBank::setResonance(float resonance)
+{
+    for (int lane = 0; lane < numLanes; ++lane)
+        setResonance(lane, resonance);
+}
+
+float StateVariableFilterBank::fastTan(float x)
+{
+    // 7th-order continued-fraction (Pade) approximant of tan
+    const float x2 = x * x;
+    const float numerator = x * (135135.0f - x2 * (17325.0f - x2 * (378.0f - x2)));
+    const float denominator = 135135.0f - x2 * (62370.0f - x2 * (3150.0f - 28.0f * x2));
+    return numerator / denominator;
+}
+
+void StateVariableFilterBank::process(float* const* laneSamples, int numSamples)
+{
+    for (int offset = 0; offset < numSamples; offset += controlInterval)
+    {
+        const int n = juce::jmin(controlInterval, numSamples - offset);
+
+        if (numLanes == 1)      processTile<1>(laneSamples, offset, n);
+        else if (numLanes <= 4) processTile<4>(laneSamples, offset, n);
+        else                    processTile<8>(laneSamples, offset, n);
+    }
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        juce::dsp::util::snapToZero(s1[(size_t) lane]);
+        juce::dsp::util::snapToZero(s2[(size_t) lane]);
+    }
+}
+
+void StateVariableFilterBank::processInterleaved(float* frames, int numSamples)
+{
+    for (int offset = 0; offset < numSamples; offset += controlInterval)
+        processFrames<maxLanes>(frames + offset * maxLanes, juce::jmin(controlInterval, numSamples - offset));
+
+    for (int lane = 0; lane < maxLanes; ++lane)
+    {
+        juce::dsp::util::snapToZero(s1[(size_t) lane]);
+        juce::dsp::util::snapToZero(s2[(size_t) lane]);
+    }
+}
+
+void StateVariableFilterBank::resetLane(int lane)
+{
+    jassert(juce::isPositiveAndBelow(lane, maxLanes));
+    s1[(size_t) lane] = 0.0f;
+    s2[(size_t) lane] = 0.0f;
+}
+
+template <int Lanes>
+void StateVariableFilterBank::processTile(float* const* laneSamples, int offset, int numSamples)
+{
+    static_assert(Lanes <= maxLanes);
+
+    // Interleave the lanes into a tile so each sample's lanes sit side by side
+    alignas(32) float tile[controlInterval][Lanes] = {};
+    for (int lane = 0; lane < juce::jmin(Lanes, numLanes); ++lane)
+    {
+        const float* source = laneSamples[lane] + offset;
+        for (int i = 0; i < numSamples; ++i)
+            tile[i][lane] = source[i];
+    }
+
+    processFrames<Lanes>(&tile[0][0], numSamples);
+
+    for (int lane = 0; lane < juce::jmin(Lanes, numLanes); ++lane)
+    {
+        float* destination = laneSamples[lane] + offset;
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] = tile[i][lane];
+    }
+}
+
+template <int Lanes>
+void StateVariableFilterBank::processFrames(float* frames, int numSamples)
+{
+    jassert(numSamples <= controlInterval);
+
+    // Output is a branch-free mix of the three SVF responses
+    const float lowGain = type == Type::lowpass ? 1.0f : 0.0f;
+    const float bandGain = type == Type::bandpass ? 1.0f : 0.0f;
+    const float highGain = type == Type::highpass ? 1.0f : 0.0f;
+
+    // The full-width bank runs the dispatched kernel; narrower ones stay here
+    if constexpr (Lanes == DspKernels::numLanes)
+    {
+        const DspKernels::FilterLanes lanes {
+            g.data(), k.data(), gTarget.data(), kTarget.data(), s1.data(), s2.data(),
+            lowGain, bandGain, highGain
+        };
+
+        DspKernels::get().filterFrames(lanes, frames, numSamples);
+        return;
+    }
+
+    alignas(32) float gs[Lanes], ks[Lanes], gStep[Lanes], kStep[Lanes], ic1[Lanes], ic2[Lanes];
+    const float rampScale = 1.0f / (float) numSamples;
+    for (int l = 0; l < Lanes; ++l)
+    {
+        gs[l] = g[(size_t) l];
+        ks[l] = k[(size_t) l];
+        gStep[l] = (gTarget[(size_t) l] - gs[l]) * rampScale;
+        kStep[l] = (kTarget[(size_t) l] - ks[l]) * rampScale;
+        ic1[l] = s1[(size_t) l];
+        ic2[l] = s2[(size_t) l];
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float* frame = frames + i * Lanes;
+
+        for (int l = 0; l < Lanes; ++l)
+        {
+            gs[l] += gStep[l];
+            ks[l] += kStep[l];
+
+            const float a1 = 1.0f / (1.0f + gs[l] * (gs[l] + ks[l]));
+            const float a2 = gs[l] * a1;
+            const float a3 = gs[l] * a2;
+
+            const float v0 = frame[l];
+            const float v3 = v0 - ic2[l];
+            const float v1 = a1 * ic1[l] + a2 * v3;
+            const float v2 = ic2[l] + a2 * ic1[l] + a3 * v3;
+            ic1[l] = 2.0f * v1 - ic1[l];
+            ic2[l] = 2.0f * v2 - ic2[l];
+
+            frame[l] = lowGain * v2 + bandGain * v1 + highGain * (v0 - ks[l] * v1 - v2);
+        }
+    }
+
+    for (int l = 0; l < Lanes; ++l)
+    {
+        // Land exactly on the targets so rounding in the ramp doesn't accumulate
+        g[(size_t) l] = gTarget[(size_t) l];
+        k[(size_t) l] = kTarget[(size_t) l];
+        s1[(size_t) l] = ic1[l];
+        s2[(size_t) l] = ic2[l];
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include "Kernels/DspKernels.h"
+
+/**
+ * StateVariableFilterBank - Block-processing TPT state-variable filters, up to 8 at once.
+ *
+ * Same topology and resonance convention as juce::dsp::StateVariableTPTFilter
+ * (k = 1 / resonance), but whole buffers are processed in one call and filter
+ * instances ("lanes") are interleaved into small tiles so the per-lane maths
+ * runs in SIMD registers. One lane uses a scalar kernel, 2-4 and 5-8 lanes
+ * use 4- and 8-wide kernels; the 8-wide one is DspKernels::filterFrames.
+ *
+ * Cutoff and resonance are control-rate values: setting them only computes the
+ * target coefficient (with a rational tan approximation), and the kernel ramps
+ * linearly to it across the next tile of at most controlInterval samples.
+ */
+class StateVariableFilterBank
+{
+public:
+    static constexpr int maxLanes = DspKernels::numLanes;
+    static constexpr int controlInterval = 32;
+
+    enum class Type
+    {
+        lowpass,
+        bandpass,
+        highpass
+    };
+
+    void prepare(double newSampleRate, int newNumLanes = 1);
+    void reset();
+
+    void setType(Type newType);
+
+    // Control-rate targets; the coefficients glide there over the next tile
+    void setCutoffFrequency(int lane, float frequency);
+    void setResonance(int lane, float resonance);
+
+    // Sets every lane at once
+    void setCutoffFrequency(float frequency);
+    void setResonance(float resonance);
+
+    // Filters numLanes buffers of numSamples in place
+    void process(float* const* laneSamples, int numSamples);
+
+    // Filters lane 0 in place
+    void process(float* samples, int numSamples) { process(&samples, numSamples); }
+
+    // Filters all maxLanes lanes of interleaved frames in place: frames[i * maxLanes + lane].
+    // The layout the kernel works in, so there is nothing to shuffle.
+    void processInterleaved(float* frames, int numSamples);
+
+    // Clears one lane's integrators, e.g. when a new voice takes it over
+    void resetLane(int lane);
+
+    int getNumLanes() const { return numLanes; }
+
+    // tan(x) for x in [0, pi/2), within 1e-5 relative up to 0.49 * sampleRate
+    static float fastTan(float x);
+
+private:
+    Type type = Type::lowpass;
+    double sampleRate = 44100.0;
+    int numLanes = 1;
+
+    // Current and target coefficients, plus the two integrator states, per lane
+    alignas(32) std::array<float, maxLanes> g {};
+    alignas(32) std::array<float, maxLanes> k {};
+    alignas(32) std::array<float, maxLanes> gTarget {};
+    alignas(32) std::array<float, maxLanes> kTarget {};
+    alignas(32) std::array<float, maxLanes> s1 {};
+    alignas(32) std::array<float, maxLanes> s2 {};
+
+    std::array<float, maxLanes> cutoffs {};
+
+    template <int Lanes>
+    void processTile(float* const* laneSamples, int offset, int numSamples);
+
+    // The filter itself, on at most controlInterval frames of Lanes interleaved samples
+    template <int Lanes>
+    void processFrames(float* frames, int numSamples);
+};
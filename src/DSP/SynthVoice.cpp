@@ -1 +1,134 @@
-// ...existing code...
+#include "SynthVoice.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+
+SynthVoice::SynthVoice(OscillatorLayer& oscillators, EnvelopeBank& envelopes, int voiceIndex)
+    : oscillatorLayer(oscillators),
+      envelopeBank(envelopes),
+      oscillatorVoice(voiceIndex)
+{
+    jassert(juce::isPositiveAndBelow(voiceIndex, juce::jmin(OscillatorLayer::maxVoices, EnvelopeBank::maxLanes)));
+
+    // Layer levels are applied by the engine's mixer, so the layers run at unity
+    subLayer.setLevel(1.0f);
+    noiseLayer.setLevel(1.0f);
+}
+
+SynthVoice::~SynthVoice() {}
+
+void SynthVoice::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    subLayer.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    noiseLayer.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void SynthVoice::releaseResources()
+{
+    subLayer.releaseResources();
+    noiseLayer.releaseResources();
+}
+
+void SynthVoice::startNote(int midiNoteNumber, float noteVelocity, juce::uint32 order)
+{
+    currentNote = midiNoteNumber;
+    velocity = noteVelocity;
+    noteOnOrder = order;
+    currentLevel = 0.0f;
+    previousLevel = 0.0f;
+
+    releasing = false;
+    renderedSinceRelease = false;
+
+    float baseFreq = static_cast<float>(juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber));
+
+    oscillatorLayer.startVoice(oscillatorVoice, baseFreq);
+    envelopeBank.noteOn(oscillatorVoice);
+
+    subLayer.setFrequency(baseFreq * 0.5f); // Sub octave
+    subLayer.setActive(true);
+
+    noiseLayer.setActive(true);
+}
+
+void SynthVoice::stopNote()
+{
+    if (!isActive() || releasing)
+        return;
+
+    releasing = true;
+    renderedSinceRelease = false;
+    envelopeBank.noteOff(oscillatorVoice);
+}
+
+void SynthVoice::finishNote()
+{
+    oscillatorLayer.stopVoice(oscillatorVoice);
+    envelopeBank.stop(oscillatorVoice);
+    subLayer.setActive(false);
+    noiseLayer.setActive(false);
+
+    currentNote = -1;
+    currentLevel = 0.0f;
+    previousLevel = 0.0f;
+    releasing = false;
+}
+
+bool SynthVoice::isSilent() const
+{
+    // The envelope ends the release even when no layer is being rendered; the
+    // levels can end it sooner, e.g. when the layers are quieter than the envelope
+    return releasing && (envelopeBank.isIdle(oscillatorVoice)
+                         || (renderedSinceRelease && getCurrentLevel() < SynthLayer::silenceThreshold));
+}
+
+float SynthVoice::getCurrentLevel() const
+{
+    return juce::jmax(currentLevel, previousLevel, oscillatorLayer.getVoiceLevel(oscillatorVoice));
+}
+
+void SynthVoice::controlTick()
+{
+    // Levels cover whole tiles, so a short MIDI-split render can't read as silence
+    previousLevel = currentLevel;
+    currentLevel = 0.0f;
+
+    subLayer.controlTick();
+    noiseLayer.controlTick();
+}
+
+void SynthVoice::renderNextBlock(const LayerBuses& buses, int numSamples, juce::AudioBuffer<float>& layerBuffer)
+{
+    if (!isActive())
+        return;
+
+    // This voice's lane of the envelope frames
+    const float* envelope = envelopeBank.getFrames(buses.envelopeFrame) + oscillatorVoice;
+
+    if (buses.sub != nullptr)
+        currentLevel = juce::jmax(currentLevel, renderLayer(subLayer, buses.sub, envelope, numSamples, layerBuffer));
+
+    if (buses.noise != nullptr)
+        currentLevel = juce::jmax(currentLevel, renderLayer(noiseLayer, buses.noise, envelope, numSamples, layerBuffer));
+
+    renderedSinceRelease = releasing;
+}
+
+float SynthVoice::renderLayer(SynthLayer& layer, float* bus, const float* envelope, int numSamples,
+                              juce::AudioBuffer<float>& layerBuffer) const
+{
+    jassert(!layer.isStereo());
+
+    float* source = layerBuffer.getWritePointer(0);
+    layer.render(source, nullptr, numSamples);
+
+    // Shape, accumulate and measure in the same pass over the layer output
+    float peak = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float sample = source[i] * envelope[i * EnvelopeBank::maxLanes];
+
+        bus[i] += sample;
+        peak = juce::jmax(peak, std::abs(sample));
+    }
+
+    return peak;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Synth/OscillatorLayer.h"
+#include "../Synth/SubLayer.h"
+#include "../Synth/NoiseLayer.h"
+#include "EnvelopeBank.h"
+
+/**
+ * SynthVoice - One note of the ambient pad engine.
+ *
+ * Each voice owns its own Sub/Noise layer state so that chords no longer
+ * collapse onto a single set of oscillators. Its oscillator layer is one lane
+ * of an engine-owned OscillatorLayer bank, which renders up to eight voices
+ * per SIMD instruction. Its envelope is the same lane of an engine-owned
+ * EnvelopeBank, which shapes the oscillator lane and the voice's own layers.
+ * Voices are created once by SynthEngine1::prepareToPlay and recycled
+ * afterwards, so starting or stealing a note never allocates.
+ *
+ * stopNote() starts the envelope's release; the voice stays active until the
+ * engine sees it has gone silent (isSilent()) and calls finishNote(). From
+ * then on it isn't processed at all.
+ */
+class SynthVoice
+{
+public:
+    // Engine-owned mono accumulators, one per layer; nullptr = layer disabled.
+    // Level and pan are applied once to each bus by the engine's LayerMixer.
+    // The oscillator bus is filled by the engine's OscillatorLayer banks.
+    struct LayerBuses
+    {
+        float* sub = nullptr;
+        float* noise = nullptr;
+        int envelopeFrame = 0; // Where this render starts in the EnvelopeBank's frames
+    };
+
+    // oscillatorVoice is this voice's lane in the shared oscillator and envelope banks
+    SynthVoice(OscillatorLayer& oscillators, EnvelopeBank& envelopes, int oscillatorVoice);
+    ~SynthVoice();
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+    void releaseResources();
+
+    // Note lifecycle - noteOnOrder is a monotonically increasing stamp used for stealing
+    void startNote(int midiNoteNumber, float velocity, juce::uint32 noteOnOrder);
+    void stopNote();   // Starts the release
+    void finishNote(); // Ends the note immediately
+
+    bool isActive() const { return currentNote >= 0; } // Playing or releasing
+    bool isReleasing() const { return releasing; }
+    bool isSilent() const; // Release finished, or decayed below SynthLayer::silenceThreshold
+    int getCurrentNote() const { return currentNote; }
+    float getVelocity() const { return velocity; }
+    juce::uint32 getNoteOnOrder() const { return noteOnOrder; }
+    float getCurrentLevel() const; // Pre-mix peak over the current and the previous control tile
+
+    // Layer accessors for per-voice parameter updates
+    SubLayer& getSubLayer() { return subLayer; }
+    NoiseLayer& getNoiseLayer() { return noiseLayer; }
+
+    // Control-rate update, called by the engine once per tile
+    void controlTick();
+
+    // Adds numSamples of each enabled layer to its bus, shaped by the envelope frames
+    // EnvelopeBank::process() already stored for them. layerBuffer is single-channel scratch space with at least numSamples samples.
+    void renderNextBlock(const LayerBuses& buses, int numSamples, juce::AudioBuffer<float>& layerBuffer);
+
+private:
+    OscillatorLayer& oscillatorLayer;
+    EnvelopeBank& envelopeBank;
+    const int oscillatorVoice;
+    SubLayer subLayer;
+    NoiseLayer noiseLayer;
+
+    int currentNote = -1;
+    float velocity = 0.0f;
+    juce::uint32 noteOnOrder = 0;
+    float currentLevel = 0.0f; // Peak of the sub and noise layers since the last control tick
+    float previousLevel = 0.0f;
+
+    bool releasing = false;
+    bool renderedSinceRelease = false; // Levels only tell silence once they cover the release
+
+    // Renders one mono layer into layerBuffer and adds it to bus with the envelope applied,
+    // returns its peak
+    float renderLayer(SynthLayer& layer, float* bus, const float* envelope, int numSamples,
+                      juce::AudioBuffer<float>& layerBuffer) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SynthVoice)
+};
@@ -1 +1,105 @@
-// ...existing code...
+#include "VoidOscillator.h"
+#include <cmath>
+
+void VoidOscillator::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    setFrequency(frequency);
+    crossfadeRemaining = 0;
+}
+
+void VoidOscillator::setTable(const WaveTableBank::WaveTable* newTable)
+{
+    if (newTable == table)
+        return;
+
+    // Only crossfade when there is something audible to fade from
+    previousTable = table;
+    crossfadeRemaining = previousTable != nullptr ? crossfadeSamples : 0;
+    table = newTable;
+}
+
+void VoidOscillator::setFrequency(float newFrequency)
+{
+    frequency = newFrequency;
+    phaseIncrement = juce::jlimit(0.0f, 0.5f, (float) (frequency / sampleRate));
+    mipLevel = WaveTableBank::getMipLevelForIncrement(phaseIncrement);
+}
+
+void VoidOscillator::process(float* destination, int numSamples, float gain)
+{
+    jassert(table != nullptr);
+
+    float positions[chunkSize];
+    float samples[chunkSize];
+    float previous[chunkSize];
+
+    const float* current = table->levels[(size_t) mipLevel].data();
+
+    for (int offset = 0; offset < numSamples; offset += chunkSize)
+    {
+        const int n = juce::jmin(chunkSize, numSamples - offset);
+
+        advancePhase(positions, n);
+        readTable(current, positions, samples, n);
+
+        if (crossfadeRemaining > 0)
+        {
+            // Fade weight runs from crossfadeRemaining / crossfadeSamples down to zero
+            readTable(previousTable->levels[(size_t) mipLevel].data(), positions, previous, n);
+
+            const float step = 1.0f / (float) crossfadeSamples;
+            const float startFade = (float) crossfadeRemaining * step;
+            for (int i = 0; i < n; ++i)
+            {
+                const float fade = juce::jmax(0.0f, startFade - (float) i * step);
+                samples[i] += (previous[i] - samples[i]) * fade;
+            }
+
+            crossfadeRemaining = juce::jmax(0, crossfadeRemaining - n);
+        }
+
+        float* out = destination + offset;
+        for (int i = 0; i < n; ++i)
+            out[i] += samples[i] * gain;
+    }
+}
+
+void VoidOscillator::advancePhase(float* positions, int numSamples)
+{
+    const float start = phase;
+    const float increment = phaseIncrement;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float p = start + increment * (float) i;
+        positions[i] = (p - std::floor(p)) * (float) WaveTableBank::tableSize;
+    }
+
+    const float end = start + increment * (float) numSamples;
+    phase = end - std::floor(end);
+}
+
+void VoidOscillator::readTable(const float* samples, const float* positions, float* output, int numSamples)
+{
+    int indices[chunkSize];
+    float fracs[chunkSize];
+    float a[chunkSize];
+    float b[chunkSize];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        indices[i] = (int) positions[i];
+        fracs[i] = positions[i] - (float) indices[i];
+    }
+
+    // Gather - the only part that doesn't map to plain SIMD loads
+    for (int i = 0; i < numSamples; ++i)
+    {
+        a[i] = samples[indices[i]];
+        b[i] = samples[indices[i] + 1];
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+        output[i] = a[i] + (b[i] - a[i]) * fracs[i];
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include "WaveTableBank.h"
+
+/**
+ * VoidOscillator - Band-limited wavetable oscillator reading a shared WaveTableBank.
+ *
+ * The oscillator only stores a pointer to its table, so changing waveform is a
+ * pointer swap; the previous table keeps playing underneath for a short
+ * crossfade so the switch doesn't click. The mip level is chosen whenever the
+ * frequency changes so the highest harmonic played stays below Nyquist.
+ *
+ * process() renders blocks in small chunks: phase positions and interpolation
+ * are computed in separate straight-line loops the compiler can vectorise, with
+ * only the table reads left as scalar gathers.
+ */
+class VoidOscillator
+{
+public:
+    static constexpr int crossfadeSamples = 256;
+
+    void prepare(double newSampleRate);
+    void reset() { phase = 0.0f; }
+
+    // Swaps to a new table, crossfading from the current one if it is playing
+    void setTable(const WaveTableBank::WaveTable* newTable);
+    void setFrequency(float frequency);
+
+    // Adds numSamples of output scaled by gain to destination
+    void process(float* destination, int numSamples, float gain);
+
+    float processSample()
+    {
+        jassert(table != nullptr);
+
+        float sample = readTable(table->levels[(size_t) mipLevel].data(), phase);
+
+        if (crossfadeRemaining > 0)
+        {
+            const float fade = (float) crossfadeRemaining / (float) crossfadeSamples;
+            sample += (readTable(previousTable->levels[(size_t) mipLevel].data(), phase) - sample) * fade;
+            --crossfadeRemaining;
+        }
+
+        phase += phaseIncrement;
+        if (phase >= 1.0f)
+            phase -= 1.0f;
+
+        return sample;
+    }
+
+private:
+    static constexpr int chunkSize = 64;
+
+    const WaveTableBank::WaveTable* table = nullptr;
+    const WaveTableBank::WaveTable* previousTable = nullptr;
+    int crossfadeRemaining = 0;
+
+    float phase = 0.0f; // Normalised 0-1
+    float phaseIncrement = 0.0f;
+    int mipLevel = 0;
+    float frequency = 440.0f;
+    double sampleRate = 44100.0;
+
+    static float readTable(const float* samples, float readPhase)
+    {
+        const float position = readPhase * (float) WaveTableBank::tableSize;
+        const int index = (int) position;
+        const float frac = position - (float) index;
+        return samples[index] + (samples[index + 1] - samples[index]) * frac;
+    }
+
+    // Fills positions with table positions for the next numSamples and advances the phase
+    void advancePhase(float* positions, int numSamples);
+
+    // Linear interpolation of one mip level at precomputed positions
+    static void readTable(const float* samples, const float* positions, float* output, int numSamples);
+};
@@ -0,0 +1,121 @@
+#include "WaveTableBank.h"
+#include <juce_dsp/juce_dsp.h>
+#include <cmath>
+
+namespace
+{
+    // Shapes are defined over x in [-pi, pi), matching juce::dsp::Oscillator's phase
+    float sawShape(float x)      { return x / juce::MathConstants<float>::pi; }
+    float squareShape(float x)   { return x < 0.0f ? -1.0f : 1.0f; }
+    float triangleShape(float x) { return std::asin(std::sin(x)) * (2.0f / juce::MathConstants<float>::pi); }
+    float sineShape(float x)     { return std::sin(x); }
+}
+
+WaveTableBank::WaveTableBank()
+{
+    using ShapeFunction = float (*)(float);
+    const ShapeFunction shapes[user] = { sawShape, squareShape, triangleShape, sineShape };
+
+    std::array<float, tableSize> cycle;
+    for (int w = 0; w < user; ++w)
+    {
+        for (int i = 0; i < tableSize; ++i)
+        {
+            const float x = juce::MathConstants<float>::twoPi * (float) i / (float) tableSize - juce::MathConstants<float>::pi;
+            cycle[(size_t) i] = shapes[w](x);
+        }
+
+        buildMipLevels(cycle.data(), builtInTables[(size_t) w], false);
+    }
+}
+
+const WaveTableBank::WaveTable* WaveTableBank::getTable(int waveform) const
+{
+    if (waveform == user)
+        return &builtInTables[sine];
+
+    return &builtInTables[(size_t) juce::jlimit(0, user - 1, waveform)];
+}
+
+std::unique_ptr<WaveTableBank::WaveTable> WaveTableBank::createUserTable(const float* singleCycle, int numSamples)
+{
+    if (singleCycle == nullptr || numSamples < 2)
+        return nullptr;
+
+    // Resample the cycle to the table length with linear interpolation
+    std::vector<float> cycle((size_t) tableSize);
+    const float step = (float) numSamples / (float) tableSize;
+    for (int i = 0; i < tableSize; ++i)
+    {
+        const float position = (float) i * step;
+        const int index = (int) position;
+        const float frac = position - (float) index;
+        const float a = singleCycle[index];
+        const float b = singleCycle[(index + 1) % numSamples];
+        cycle[(size_t) i] = a + (b - a) * frac;
+    }
+
+    auto table = std::make_unique<WaveTable>();
+    buildMipLevels(cycle.data(), *table, true);
+    return table;
+}
+
+int WaveTableBank::getMipLevelForIncrement(float phaseIncrement)
+{
+    // Highest harmonic h sits at h * phaseIncrement cycles per sample and must stay below 0.5
+    int level = 0;
+    while (level < numMipLevels - 1 && (float) WaveTable::getMaxHarmonic(level) * phaseIncrement > 0.5f)
+        ++level;
+    return level;
+}
+
+void WaveTableBank::buildMipLevels(const float* cycle, WaveTable& destination, bool normalise)
+{
+    juce::dsp::FFT fft(fftOrder);
+    std::vector<float> spectrum((size_t) tableSize * 2, 0.0f);
+    std::vector<float> work((size_t) tableSize * 2, 0.0f);
+
+    // Measure the FFT's round-trip gain once with a cosine, so the result doesn't
+    // depend on which backend (and normalisation convention) JUCE picked
+    for (int i = 0; i < tableSize; ++i)
+        work[(size_t) i] = std::cos(juce::MathConstants<float>::twoPi * (float) i / (float) tableSize);
+    fft.performRealOnlyForwardTransform(work.data(), true);
+    fft.performRealOnlyInverseTransform(work.data());
+    const float roundTripGain = std::abs(work[0]) > 0.0f ? 1.0f / work[0] : 1.0f;
+
+    std::copy(cycle, cycle + tableSize, spectrum.begin());
+    fft.performRealOnlyForwardTransform(spectrum.data(), true);
+
+    // Bins are interleaved (re, im); remove DC so levels don't carry an offset
+    spectrum[0] = spectrum[1] = 0.0f;
+
+    float gain = roundTripGain;
+    for (int level = 0; level < numMipLevels; ++level)
+    {
+        const int maxHarmonic = WaveTable::getMaxHarmonic(level);
+
+        std::fill(work.begin(), work.end(), 0.0f);
+        std::copy(spectrum.begin(), spectrum.begin() + (maxHarmonic + 1) * 2, work.begin());
+
+        // The Nyquist bin has no phase and can't be represented cleanly
+        if (maxHarmonic == tableSize / 2)
+            work[(size_t) tableSize] = work[(size_t) tableSize + 1] = 0.0f;
+
+        fft.performRealOnlyInverseTransform(work.data());
+
+        // User tables are peak-normalised on the full-band level; every level shares that gain
+        if (normalise && level == 0)
+        {
+            float peak = 0.0f;
+            for (int i = 0; i < tableSize; ++i)
+                peak = juce::jmax(peak, std::abs(work[(size_t) i] * roundTripGain));
+            if (peak > 0.0f)
+                gain = roundTripGain / peak;
+        }
+
+        auto& samples = destination.levels[(size_t) level];
+        for (int i = 0; i < tableSize; ++i)
+            samples[(size_t) i] = work[(size_t) i] * gain;
+        samples[tableSize] = samples[0];
+    }
+}
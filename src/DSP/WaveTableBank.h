@@ -0,0 +1,66 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+/**
+ * WaveTableBank - Read-only, band-limited waveform tables shared by every oscillator.
+ *
+ * Each waveform is stored as a set of per-octave mip levels: level k keeps only
+ * the first (tableSize / 2) >> k harmonics, so an oscillator can pick the level
+ * whose highest harmonic stays below Nyquist and play clean highs without
+ * oversampling. The built-in tables are created once when the first instance is
+ * made and never written again. Hold the bank through
+ * juce::SharedResourcePointer<WaveTableBank>.
+ *
+ * Imported user tables are built with createUserTable() but never stored here:
+ * each plugin instance keeps its own (see ResourceManager::loadWavetable), so
+ * importing one never changes the sound of another instance.
+ */
+class WaveTableBank
+{
+public:
+    // Order matches the "osc1Waveform"/"subWaveform" parameter choices
+    enum Waveform
+    {
+        saw = 0,
+        square,
+        triangle,
+        sine,
+        user,
+        numWaveforms
+    };
+
+    static constexpr int fftOrder = 11;
+    static constexpr int tableSize = 1 << fftOrder;
+    static constexpr int numMipLevels = fftOrder; // 1024 harmonics down to 1
+
+    struct WaveTable
+    {
+        // One extra guard point per level equal to sample 0 so interpolation never wraps
+        using Level = std::array<float, tableSize + 1>;
+        std::array<Level, numMipLevels> levels;
+
+        // Highest harmonic kept in a mip level
+        static constexpr int getMaxHarmonic(int level) { return (tableSize / 2) >> level; }
+    };
+
+    WaveTableBank();
+
+    // Never returns nullptr - "user" falls back to sine, the bank holds no user table
+    const WaveTable* getTable(int waveform) const;
+
+    // Builds a band-limited user table from one cycle of any length (never on the audio thread)
+    static std::unique_ptr<WaveTable> createUserTable(const float* singleCycle, int numSamples);
+
+    // Picks the mip level whose harmonics stay below Nyquist for a phase increment (frequency / sampleRate)
+    static int getMipLevelForIncrement(float phaseIncrement);
+
+private:
+    std::array<WaveTable, user> builtInTables;
+
+    static void buildMipLevels(const float* cycle, WaveTable& destination, bool normalise);
+
+    JUCE_DECLARE_NON_COPYABLE(WaveTableBank)
+};
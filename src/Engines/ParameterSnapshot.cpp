@@ -0,0 +1,113 @@
+#include "ParameterSnapshot.h"
+
+namespace
+{
+    std::atomic<float>* getHandle(juce::AudioProcessorValueTreeState& apvts, const char* parameterID)
+    {
+        auto* handle = apvts.getRawParameterValue(parameterID);
+        jassert(handle != nullptr); // Parameter missing from createParameterLayout()
+        return handle;
+    }
+
+    template <typename T> T convertValue(float raw);
+    template <> bool convertValue<bool>(float raw) { return raw > 0.5f; }
+    template <> int convertValue<int>(float raw) { return juce::roundToInt(raw); }
+}
+
+ParameterSnapshot::ParameterSnapshot(juce::AudioProcessorValueTreeState& apvts, const SmootherBank& smootherBank)
+    : smoothers(&smootherBank)
+{
+    handles.oscEnable = getHandle(apvts, "osc1Enable");
+    handles.subEnable = getHandle(apvts, "subEnable");
+    handles.noiseEnable = getHandle(apvts, "noiseEnable");
+    handles.samplerEnable = getHandle(apvts, "samplerEnable");
+
+    handles.oscLevel = smootherBank.getIndex("osc1Level");
+    handles.subLevel = smootherBank.getIndex("subLevel");
+    handles.noiseLevel = smootherBank.getIndex("noiseLevel");
+    handles.samplerLevel = smootherBank.getIndex("samplerLevel");
+
+    handles.oscPan = smootherBank.getIndex("osc1Pan");
+    handles.subPan = smootherBank.getIndex("subPan");
+    handles.noisePan = smootherBank.getIndex("noisePan");
+    handles.samplerPan = smootherBank.getIndex("samplerPan");
+
+    handles.multithreading = getHandle(apvts, "multithreading");
+
+    handles.oscWaveform = getHandle(apvts, "osc1Waveform");
+    handles.oscMode = getHandle(apvts, "osc1Mode");
+    handles.oscDetune = smootherBank.getIndex("osc1Detune");
+    handles.oscUnison = getHandle(apvts, "osc1Unison");
+    handles.oscDetuneCurve = smootherBank.getIndex("osc1DetuneCurve");
+    handles.oscSpread = smootherBank.getIndex("osc1Spread");
+    handles.oscPhaseRandom = smootherBank.getIndex("osc1PhaseRandom");
+    handles.filterCutoff = smootherBank.getIndex("filterCutoff");
+    handles.filterResonance = smootherBank.getIndex("filterResonance");
+    handles.filterKeyTrack = smootherBank.getIndex("filterKeyTrack");
+    handles.filterEnvAmount = smootherBank.getIndex("filterEnvAmount");
+    handles.noiseType = getHandle(apvts, "noiseType");
+    handles.noiseFilterCutoff = smootherBank.getIndex("noiseFilterCutoff");
+
+    handles.attackTime = smootherBank.getIndex("attackTime");
+    handles.decayTime = smootherBank.getIndex("decayTime");
+    handles.sustainLevel = smootherBank.getIndex("sustainLevel");
+    handles.releaseTime = smootherBank.getIndex("releaseTime");
+}
+
+template <typename T>
+void ParameterSnapshot::load(Value<T>& target, std::atomic<float>* handle)
+{
+    const T newValue = convertValue<T>(handle->load(std::memory_order_relaxed));
+    target.changed = forceChanged || newValue != target.value;
+    target.value = newValue;
+}
+
+void ParameterSnapshot::load(Value<float>& target, int smootherIndex)
+{
+    const float newValue = smoothers->getValueAt(smootherIndex, currentOffset);
+    target.changed = forceChanged || newValue != target.value;
+    target.value = newValue;
+}
+
+void ParameterSnapshot::update(int sampleOffset)
+{
+    currentOffset = sampleOffset;
+
+    load(oscEnable, handles.oscEnable);
+    load(subEnable, handles.subEnable);
+    load(noiseEnable, handles.noiseEnable);
+    load(samplerEnable, handles.samplerEnable);
+
+    load(oscLevel, handles.oscLevel);
+    load(subLevel, handles.subLevel);
+    load(noiseLevel, handles.noiseLevel);
+    load(samplerLevel, handles.samplerLevel);
+
+    load(oscPan, handles.oscPan);
+    load(subPan, handles.subPan);
+    load(noisePan, handles.noisePan);
+    load(samplerPan, handles.samplerPan);
+
+    load(multithreading, handles.multithreading);
+
+    load(oscWaveform, handles.oscWaveform);
+    load(oscMode, handles.oscMode);
+    load(oscDetune, handles.oscDetune);
+    load(oscUnison, handles.oscUnison);
+    load(oscDetuneCurve, handles.oscDetuneCurve);
+    load(oscSpread, handles.oscSpread);
+    load(oscPhaseRandom, handles.oscPhaseRandom);
+    load(filterCutoff, handles.filterCutoff);
+    load(filterResonance, handles.filterResonance);
+    load(filterKeyTrack, handles.filterKeyTrack);
+    load(filterEnvAmount, handles.filterEnvAmount);
+    load(noiseType, handles.noiseType);
+    load(noiseFilterCutoff, handles.noiseFilterCutoff);
+
+    load(attackTime, handles.attackTime);
+    load(decayTime, handles.decayTime);
+    load(sustainLevel, handles.sustainLevel);
+    load(releaseTime, handles.releaseTime);
+
+    forceChanged = false;
+}
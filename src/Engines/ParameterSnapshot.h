@@ -0,0 +1,110 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Core/SmootherBank.h"
+
+/**
+ * ParameterSnapshot - One consistent read of the engine's parameters per block.
+ *
+ * Raw parameter handles are looked up by ID once at construction, so update()
+ * is a handful of atomic loads instead of string-keyed map lookups. Every value
+ * carries a changed flag so dependent state (oscillator tables, detune ratios,
+ * filter coefficients) is only recomputed when the value actually moved.
+ *
+ * Float values come from the processor's SmootherBank, sampled at the end of
+ * the chunk being rendered, so automation reaches the engine as a ramp.
+ *
+ * Snapshots are plain values: the engine copies one per tile when it hands a
+ * span of tiles to its render workers.
+ */
+class ParameterSnapshot
+{
+public:
+    template <typename T>
+    struct Value
+    {
+        T value {};
+        bool changed = true; // Differs from the previous update()
+
+        operator T() const { return value; }
+    };
+
+    ParameterSnapshot(juce::AudioProcessorValueTreeState& apvts, const SmootherBank& smoothers);
+
+    // Loads every cached handle and refreshes the changed flags. Float values are
+    // read from the smoothers at sampleOffset within the current host block.
+    void update(int sampleOffset);
+
+    // Reports every value as changed on the next update(), e.g. after prepareToPlay
+    void markAllChanged() { forceChanged = true; }
+
+    // Layer enables
+    Value<bool> oscEnable, subEnable, noiseEnable, samplerEnable;
+
+    // Layer levels and pans
+    Value<float> oscLevel, subLevel, noiseLevel, samplerLevel;
+    Value<float> oscPan, subPan, noisePan, samplerPan;
+
+    // Engine
+    Value<bool> multithreading;
+
+    // Layer sound parameters
+    Value<int> oscWaveform;
+    Value<int> oscMode;
+    Value<float> oscDetune;
+    Value<int> oscUnison;
+    Value<float> oscDetuneCurve;
+    Value<float> oscSpread;
+    Value<float> oscPhaseRandom;
+    Value<float> filterCutoff, filterResonance, filterKeyTrack, filterEnvAmount;
+    Value<int> noiseType;
+    Value<float> noiseFilterCutoff;
+
+    // Envelope
+    Value<float> attackTime, decayTime, sustainLevel, releaseTime;
+
+private:
+    // Raw handles for discrete values, smoother indices for float values
+    struct Handles
+    {
+        std::atomic<float>* oscEnable;
+        std::atomic<float>* subEnable;
+        std::atomic<float>* noiseEnable;
+        std::atomic<float>* samplerEnable;
+        int oscLevel;
+        int subLevel;
+        int noiseLevel;
+        int samplerLevel;
+        int oscPan;
+        int subPan;
+        int noisePan;
+        int samplerPan;
+        std::atomic<float>* multithreading;
+        std::atomic<float>* oscWaveform;
+        std::atomic<float>* oscMode;
+        int oscDetune;
+        std::atomic<float>* oscUnison;
+        int oscDetuneCurve;
+        int oscSpread;
+        int oscPhaseRandom;
+        int filterCutoff;
+        int filterResonance;
+        int filterKeyTrack;
+        int filterEnvAmount;
+        std::atomic<float>* noiseType;
+        int noiseFilterCutoff;
+        int attackTime;
+        int decayTime;
+        int sustainLevel;
+        int releaseTime;
+    };
+
+    Handles handles;
+    bool forceChanged = true;
+
+    const SmootherBank* smoothers; // Pointer so snapshots can be copied
+    int currentOffset = 0;
+
+    template <typename T>
+    void load(Value<T>& target, std::atomic<float>* handle);
+    void load(Value<float>& target, int smootherIndex);
+};
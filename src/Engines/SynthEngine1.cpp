@@ -1,150 +1,660 @@
 #include "SynthEngine1.h"
+#include "../DSP/Kernels/DspKernels.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
 
-SynthEngine1::SynthEngine1(juce::AudioProcessorValueTreeState& apvts)
+SynthEngine1::SynthEngine1(juce::AudioProcessorValueTreeState& apvts, const SmootherBank& smoothers)
     : apvts(apvts),
-      oscillatorLayer(),
-      subLayer(),
-      noiseLayer(),
+      params(apvts, smoothers),
       samplerLayer()
 {
-    // Any additional initialization if needed
+    // Layer levels are applied by the mixer, so the oscillator banks run at unity
+    for (auto& layer : oscillatorLayers)
+        layer.setLevel(1.0f);
+
+    multithreadingParam = apvts.getRawParameterValue("multithreading");
+    jassert(multithreadingParam != nullptr);
+    startTimer(250);
+}
+SynthEngine1::~SynthEngine1()
+{
+    stopTimer();
 }
-SynthEngine1::~SynthEngine1() {}
 
 void SynthEngine1::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
-    oscillatorLayer.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    subLayer.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    noiseLayer.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    // Pick the kernel variant for this CPU here rather than on the first audio callback
+    DspKernels::get();
+
+    // Allocate the voice pool once - note-on only ever recycles these
+    if (voices.empty())
+    {
+        voices.reserve(maxVoices);
+        for (int i = 0; i < maxVoices; ++i)
+        {
+            const auto bank = (size_t) (i / OscillatorLayer::maxVoices);
+            voices.push_back(std::make_unique<SynthVoice>(oscillatorLayers[bank], envelopes[bank],
+                                                          i % OscillatorLayer::maxVoices));
+        }
+    }
+
+    for (auto& layer : oscillatorLayers)
+        layer.prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    // Long enough for a whole span, so the parallel path can advance them up front
+    for (auto& envelope : envelopes)
+        envelope.prepare(sampleRate, spanSize);
+
+    for (auto& voice : voices)
+        voice->prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    // Rendering never exceeds one tile, so the arena stays small enough for L1
+    scratch.prepare(numScratchChannels, tileSize);
+
+    // Worker threads for the optional parallel path, started only while it's enabled.
+    // The scratch is sized for them either way, so enabling it never allocates here.
+    {
+        const juce::SpinLock::ScopedLockType lock(renderThreadsLock);
+        renderThreads.stop();
+        renderWorkers = juce::jlimit(0, maxVoiceGroups - 1, juce::SystemStats::getNumPhysicalCpus() - 1);
+        preparedBlockSize = samplesPerBlockExpected;
+        preparedSampleRate = sampleRate;
+    }
+    updateRenderThreads();
+
+    if (renderWorkers > 0)
+        spanScratch.prepare((renderWorkers + 1) * numGroupChannels + 2, spanSize);
+    else
+        spanScratch.release();
+
+    spanPieces.assign(maxSpanTiles + 1, SpanPiece { params });
+
+    // Freshly prepared layers need every parameter pushed again
+    params.markAllChanged();
+    samplesUntilControlTick = 0;
+
     samplerLayer.prepareToPlay(samplesPerBlockExpected, sampleRate);
 }
 
 void SynthEngine1::releaseResources()
 {
-    oscillatorLayer.releaseResources();
-    subLayer.releaseResources();
-    noiseLayer.releaseResources();
+    for (auto& voice : voices)
+        voice->releaseResources();
+
+    for (auto& layer : oscillatorLayers)
+        layer.releaseResources();
+
+    for (auto& envelope : envelopes)
+        envelope.releaseResources();
+
     samplerLayer.releaseResources();
+    {
+        const juce::SpinLock::ScopedLockType lock(renderThreadsLock);
+        renderThreads.stop();
+        renderWorkers = 0; // Stays stopped until the next prepareToPlay
+    }
+    scratch.release();
+    spanScratch.release();
+}
+
+void SynthEngine1::updateRenderThreads()
+{
+    const int numWorkers = multithreadingParam->load() >= 0.5f ? renderWorkers : 0;
+    if (numWorkers == renderThreads.getNumWorkers())
+        return;
+
+    // Waits out a parallel render in progress; starting realtime threads takes a while,
+    // but the audio thread only try-locks, so it renders serially until this is done
+    const juce::SpinLock::ScopedLockType lock(renderThreadsLock);
+
+    if (numWorkers > 0)
+        renderThreads.start(numWorkers, preparedBlockSize, preparedSampleRate);
+    else
+        renderThreads.stop();
+}
+
+void SynthEngine1::noteOn(int midiNoteNumber, float velocity)
+{
+    // Retrigger a voice already playing this note instead of stacking a duplicate
+    SynthVoice* voice = findVoiceForNote(midiNoteNumber);
+
+    if (voice == nullptr)
+        voice = findFreeVoice();
+
+    if (voice == nullptr)
+        voice = findVoiceToSteal();
+
+    if (voice != nullptr)
+        voice->startNote(midiNoteNumber, velocity, ++noteOnCounter);
+}
+
+void SynthEngine1::noteOff(int midiNoteNumber)
+{
+    for (auto& voice : voices)
+        if (voice->getCurrentNote() == midiNoteNumber && !voice->isReleasing())
+            voice->stopNote();
+}
+
+void SynthEngine1::allNotesOff()
+{
+    for (auto& voice : voices)
+        if (voice->isActive())
+            voice->stopNote();
+}
+
+double SynthEngine1::getTailLengthSeconds() const
+{
+    // The envelope's release reaches the silence threshold in releaseTime
+    const auto* releaseTime = apvts.getRawParameterValue("releaseTime");
+    return releaseTime != nullptr ? (double) releaseTime->load(std::memory_order_relaxed) : 0.0;
+}
+
+int SynthEngine1::getNumActiveVoices() const
+{
+    int numActive = 0;
+    for (auto& voice : voices)
+        if (voice->isActive())
+            ++numActive;
+    return numActive;
+}
+
+const SynthVoice* SynthEngine1::getVoiceForNote(int midiNoteNumber) const
+{
+    return findVoiceForNote(midiNoteNumber);
+}
+
+SynthVoice* SynthEngine1::findVoiceForNote(int midiNoteNumber) const
+{
+    for (auto& voice : voices)
+        if (voice->getCurrentNote() == midiNoteNumber)
+            return voice.get();
+    return nullptr;
+}
+
+SynthVoice* SynthEngine1::findFreeVoice() const
+{
+    for (auto& voice : voices)
+        if (!voice->isActive())
+            return voice.get();
+    return nullptr;
+}
+
+SynthVoice* SynthEngine1::findVoiceToSteal() const
+{
+    // Prefer voices that have already gone quiet (below -60 dB), then the oldest
+    // released note, then the oldest note
+    constexpr float quietLevel = 0.001f;
+
+    SynthVoice* oldest = nullptr;
+    SynthVoice* oldestReleased = nullptr;
+    SynthVoice* oldestQuiet = nullptr;
+
+    for (auto& voice : voices)
+    {
+        if (oldest == nullptr || voice->getNoteOnOrder() < oldest->getNoteOnOrder())
+            oldest = voice.get();
+
+        if (voice->isReleasing()
+            && (oldestReleased == nullptr || voice->getNoteOnOrder() < oldestReleased->getNoteOnOrder()))
+            oldestReleased = voice.get();
+
+        if (voice->getCurrentLevel() < quietLevel
+            && (oldestQuiet == nullptr || voice->getNoteOnOrder() < oldestQuiet->getNoteOnOrder()))
+            oldestQuiet = voice.get();
+    }
+
+    if (oldestQuiet != nullptr)
+        return oldestQuiet;
+
+    return oldestReleased != nullptr ? oldestReleased : oldest;
+}
+
+void SynthEngine1::retireSilentVoices()
+{
+    for (auto& voice : voices)
+        if (voice->isActive() && voice->isSilent())
+            voice->finishNote();
 }
 
 void SynthEngine1::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    // Get parameter values from APVTS
-    auto oscEnable = apvts.getRawParameterValue("osc1Enable")->load();
-    auto subEnable = apvts.getRawParameterValue("subEnable")->load();
-    auto noiseEnable = apvts.getRawParameterValue("noiseEnable")->load();
-    auto samplerEnable = apvts.getRawParameterValue("samplerEnable")->load();
-    
-    auto oscLevel = apvts.getRawParameterValue("osc1Level")->load();
-    auto subLevel = apvts.getRawParameterValue("subLevel")->load();
-    auto noiseLevel = apvts.getRawParameterValue("noiseLevel")->load();
-    auto samplerLevel = apvts.getRawParameterValue("samplerLevel")->load();
-    
-    auto oscPan = apvts.getRawParameterValue("osc1Pan")->load();
-    auto subPan = apvts.getRawParameterValue("subPan")->load();
-    auto noisePan = apvts.getRawParameterValue("noisePan")->load();
-    auto samplerPan = apvts.getRawParameterValue("samplerPan")->load();
-    
-    // Update enhanced layer parameters
-    auto oscWaveform = static_cast<int>(apvts.getRawParameterValue("osc1Waveform")->load());
-    auto oscDetune = apvts.getRawParameterValue("osc1Detune")->load();
-    auto noiseType = static_cast<int>(apvts.getRawParameterValue("noiseType")->load());
-    auto noiseFilterCutoff = apvts.getRawParameterValue("noiseFilterCutoff")->load();
-    
-    // Apply enhanced parameters to layers
-    oscillatorLayer.setWaveform(oscWaveform);
-    oscillatorLayer.setDetune(oscDetune);
-    oscillatorLayer.setLevel(oscLevel);
-    
-    noiseLayer.setNoiseType(noiseType);
-    noiseLayer.setFilterFrequency(noiseFilterCutoff);
-    noiseLayer.setLevel(noiseLevel);
-    
-    subLayer.setLevel(subLevel);
+    if (scratch.getMaximumBlockSize() < tileSize)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
 
-    // Clear the output buffer
-    bufferToFill.buffer->clear(bufferToFill.startSample, bufferToFill.numSamples);
-    
-    // Create temporary buffers for each layer
-    juce::AudioBuffer<float> layerBuffer(bufferToFill.buffer->getNumChannels(), bufferToFill.numSamples);
-    
-    // Process Oscillator Layer
-    if (oscEnable > 0.5f) {
-        layerBuffer.clear();
-        juce::AudioSourceChannelInfo layerInfo(&layerBuffer, 0, bufferToFill.numSamples);
-        oscillatorLayer.getNextAudioBlock(layerInfo);
-        
-        // Apply level and pan
-        for (int ch = 0; ch < bufferToFill.buffer->getNumChannels(); ++ch) {
-            float panGain = 1.0f;
-            if (bufferToFill.buffer->getNumChannels() == 2) {
-                // Stereo panning: -1.0 = left, 0.0 = center, 1.0 = right
-                panGain = (ch == 0) ? (1.0f - std::max(0.0f, oscPan)) : (1.0f + std::min(0.0f, oscPan));
+    // Fixed tiles whatever the host block size. The tile phase carries over between
+    // calls, so MIDI-split sub-blocks don't change the control rate - they only
+    // split a tile's audio into shorter pieces.
+    int position = bufferToFill.startSample;
+    int remaining = bufferToFill.numSamples;
+
+    // Every voice asleep: nothing to render or update. The next block starts a fresh
+    // tile, so parameters are caught up before anything sounds again.
+    if (getNumActiveVoices() == 0)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        samplesUntilControlTick = 0;
+        return;
+    }
+
+    // Workers only pay off with several voices to share out. While the message thread
+    // is starting or stopping them the try-lock fails and this block renders serially.
+    if (params.multithreading && getNumActiveVoices() > 1)
+    {
+        const juce::SpinLock::ScopedTryLockType lock(renderThreadsLock);
+
+        if (lock.isLocked() && renderThreads.getNumWorkers() > 0)
+        {
+            while (remaining > 0)
+            {
+                const int numSamples = juce::jmin(remaining, spanSize);
+                renderSpan(*bufferToFill.buffer, position, numSamples);
+
+                position += numSamples;
+                remaining -= numSamples;
             }
-            bufferToFill.buffer->addFrom(ch, bufferToFill.startSample, 
-                                       layerBuffer, ch, 0, bufferToFill.numSamples, 
-                                       oscLevel * panGain);
+            return;
         }
     }
-    
-    // Process Sub Oscillator Layer
-    if (subEnable > 0.5f) {
-        layerBuffer.clear();
-        juce::AudioSourceChannelInfo layerInfo(&layerBuffer, 0, bufferToFill.numSamples);
-        subLayer.getNextAudioBlock(layerInfo);
-        
-        // Apply level and pan
-        for (int ch = 0; ch < bufferToFill.buffer->getNumChannels(); ++ch) {
-            float panGain = 1.0f;
-            if (bufferToFill.buffer->getNumChannels() == 2) {
-                panGain = (ch == 0) ? (1.0f - std::max(0.0f, subPan)) : (1.0f + std::min(0.0f, subPan));
-            }
-            bufferToFill.buffer->addFrom(ch, bufferToFill.startSample, 
-                                       layerBuffer, ch, 0, bufferToFill.numSamples, 
-                                       subLevel * panGain);
+
+    while (remaining > 0)
+    {
+        if (samplesUntilControlTick == 0)
+        {
+            updateControl(position + tileSize - 1);
+            samplesUntilControlTick = tileSize;
         }
+
+        const int numSamples = juce::jmin(remaining, samplesUntilControlTick);
+        renderTile(*bufferToFill.buffer, position, numSamples);
+
+        position += numSamples;
+        remaining -= numSamples;
+        samplesUntilControlTick -= numSamples;
     }
-    
-    // Process Noise Layer
-    if (noiseEnable > 0.5f) {
-        layerBuffer.clear();
-        juce::AudioSourceChannelInfo layerInfo(&layerBuffer, 0, bufferToFill.numSamples);
-        noiseLayer.getNextAudioBlock(layerInfo);
-        
-        // Apply level and pan
-        for (int ch = 0; ch < bufferToFill.buffer->getNumChannels(); ++ch) {
-            float panGain = 1.0f;
-            if (bufferToFill.buffer->getNumChannels() == 2) {
-                panGain = (ch == 0) ? (1.0f - std::max(0.0f, noisePan)) : (1.0f + std::min(0.0f, noisePan));
-            }
-            bufferToFill.buffer->addFrom(ch, bufferToFill.startSample, 
-                                       layerBuffer, ch, 0, bufferToFill.numSamples, 
-                                       noiseLevel * panGain);
+}
+
+void SynthEngine1::updateControl(int sampleOffset)
+{
+    // One read of every parameter per tile, dependent state only updated on change.
+    // Smoothed values are taken at the tile's last sample; the mixer ramps up to them.
+    // Silence is judged on whole tiles, before the levels move on.
+    retireSilentVoices();
+
+    params.update(sampleOffset);
+    applyChangedParameters();
+
+    for (auto& voice : voices)
+        if (voice->isActive())
+            voice->controlTick();
+
+    for (auto& layer : oscillatorLayers)
+        layer.controlTick();
+}
+
+void SynthEngine1::applyChangedParameters()
+{
+    // Push only the values that moved since the last snapshot. Idle voices are
+    // updated too, so a voice starting later already has the current state.
+    const bool waveformChanged = consumeWaveformChange();
+    for (auto& layer : oscillatorLayers)
+        applyOscillatorParameters(layer, params, waveformChanged, resourceManager.getUserTable());
+
+    for (auto& envelope : envelopes)
+        applyEnvelopeParameters(envelope, params);
+
+    for (auto& voice : voices)
+        applyVoiceParameters(*voice, params);
+
+    applyMixerParameters(params);
+}
+
+bool SynthEngine1::consumeWaveformChange()
+{
+    // On the parallel path this runs before the span renders, so a bank that hasn't
+    // switched tables yet still counts as reading the outgoing one
+    if (const auto* outgoing = resourceManager.getOutgoingUserTable())
+    {
+        const bool inUse = std::any_of(oscillatorLayers.begin(), oscillatorLayers.end(),
+                                       [outgoing](const OscillatorLayer& layer) { return layer.isUsingTable(outgoing); });
+        if (!inUse)
+            resourceManager.retireOutgoingUserTable();
+    }
+
+    // A newly imported user wavetable needs to reach the oscillators too
+    const bool tableChanged = resourceManager.takeUserTable();
+    return params.oscWaveform.changed || tableChanged;
+}
+
+void SynthEngine1::applyVoiceParameters(SynthVoice& voice, const ParameterSnapshot& snapshot)
+{
+    auto& noise = voice.getNoiseLayer();
+    if (snapshot.noiseType.changed)         noise.setNoiseType(snapshot.noiseType);
+    if (snapshot.noiseFilterCutoff.changed) noise.setFilterFrequency(snapshot.noiseFilterCutoff);
+}
+
+void SynthEngine1::applyOscillatorParameters(OscillatorLayer& layer, const ParameterSnapshot& snapshot, bool waveformChanged,
+                                             const WaveTableBank::WaveTable* userTable)
+{
+    // Shared by every voice in the bank, so set once per bank
+    if (waveformChanged)                    layer.setWaveform(snapshot.oscWaveform, userTable);
+    if (snapshot.oscMode.changed)           layer.setMode(snapshot.oscMode);
+    if (snapshot.oscUnison.changed)         layer.setUnison(snapshot.oscUnison);
+    if (snapshot.oscDetune.changed)         layer.setDetune(snapshot.oscDetune);
+    if (snapshot.oscDetuneCurve.changed)    layer.setDetuneCurve(snapshot.oscDetuneCurve);
+    if (snapshot.oscSpread.changed)         layer.setStereoSpread(snapshot.oscSpread);
+    if (snapshot.oscPhaseRandom.changed)    layer.setPhaseRandomness(snapshot.oscPhaseRandom);
+
+    // The resonance parameter's 0.1 - 10 range maps onto the ladder's 0 - 1
+    if (snapshot.filterCutoff.changed)      layer.setFilterCutoff(snapshot.filterCutoff);
+    if (snapshot.filterResonance.changed)   layer.setFilterResonance(juce::jmap(snapshot.filterResonance.value, 0.1f, 10.0f, 0.0f, 1.0f));
+    if (snapshot.filterKeyTrack.changed)    layer.setFilterKeyTracking(snapshot.filterKeyTrack);
+    if (snapshot.filterEnvAmount.changed)   layer.setFilterEnvelopeAmount(snapshot.filterEnvAmount);
+}
+
+void SynthEngine1::applyEnvelopeParameters(EnvelopeBank& envelope, const ParameterSnapshot& snapshot)
+{
+    if (snapshot.attackTime.changed)        envelope.setAttackTime(snapshot.attackTime);
+    if (snapshot.decayTime.changed)         envelope.setDecayTime(snapshot.decayTime);
+    if (snapshot.sustainLevel.changed)      envelope.setSustainLevel(snapshot.sustainLevel);
+    if (snapshot.releaseTime.changed)       envelope.setReleaseTime(snapshot.releaseTime);
+}
+
+void SynthEngine1::renderOscillatorLayer(OscillatorLayer& layer, float* bus, float* busRight,
+                                         float* layerBuffer, float* layerBufferRight, int numSamples)
+{
+    layer.render(layerBuffer, busRight != nullptr ? layerBufferRight : nullptr, numSamples);
+    juce::FloatVectorOperations::add(bus, layerBuffer, numSamples);
+    if (busRight != nullptr)
+        juce::FloatVectorOperations::add(busRight, layerBufferRight, numSamples);
+}
+
+bool SynthEngine1::isOscillatorStereo(const ParameterSnapshot& snapshot, int numOutputChannels)
+{
+    return snapshot.oscEnable && snapshot.oscSpread > 0.0f && numOutputChannels > 1;
+}
+
+void SynthEngine1::applyMixerParameters(const ParameterSnapshot& snapshot)
+{
+    // Layer levels used to be applied both inside the layer and again at the mix;
+    // the squared taper keeps that loudness curve with a single ramped gain
+    if (snapshot.oscLevel.changed || snapshot.oscPan.changed)
+        mixer.setGain(oscillatorInput, snapshot.oscLevel * snapshot.oscLevel, snapshot.oscPan);
+    if (snapshot.subLevel.changed || snapshot.subPan.changed)
+        mixer.setGain(subInput, snapshot.subLevel * snapshot.subLevel, snapshot.subPan);
+    if (snapshot.noiseLevel.changed || snapshot.noisePan.changed)
+        mixer.setGain(noiseInput, snapshot.noiseLevel * snapshot.noiseLevel, snapshot.noisePan);
+    if (snapshot.samplerLevel.changed || snapshot.samplerPan.changed)
+        mixer.setGain(samplerInput, snapshot.samplerLevel, snapshot.samplerPan);
+}
+
+void SynthEngine1::renderTile(juce::AudioBuffer<float>& output, int startSample, int numSamples)
+{
+    // Clear the output buffer
+    output.clear(startSample, numSamples);
+
+    if (getNumActiveVoices() == 0)
+        return;
+
+    const int numChannels = juce::jmin(output.getNumChannels(), 2);
+
+    // Per-layer buses: the oscillator banks and every voice add into them, then each bus is panned once
+    float* oscillatorSum = params.oscEnable ? scratch.getChannel(oscillatorBus) : nullptr;
+    float* oscillatorSumRight = isOscillatorStereo(params, numChannels) ? scratch.getChannel(oscillatorBusRight) : nullptr;
+    SynthVoice::LayerBuses buses;
+    if (params.subEnable)   buses.sub = scratch.getChannel(subBus);
+    if (params.noiseEnable) buses.noise = scratch.getChannel(noiseBus);
+
+    for (auto* bus : { oscillatorSum, oscillatorSumRight, buses.sub, buses.noise })
+        if (bus != nullptr)
+            juce::FloatVectorOperations::clear(bus, numSamples);
+
+    // Envelopes first - every layer of a voice reads its lane
+    for (size_t bank = 0; bank < envelopes.size(); ++bank)
+    {
+        envelopes[bank].process(0, numSamples);
+        oscillatorLayers[bank].setEnvelopeFrames(envelopes[bank].getFrames(0));
+    }
+
+    // Layers render one bank or voice at a time into the scratch channels - no allocation here
+    auto layerBuffer = scratch.getView(renderLeft, 1, numSamples);
+    if (oscillatorSum != nullptr)
+        for (auto& layer : oscillatorLayers)
+            renderOscillatorLayer(layer, oscillatorSum, oscillatorSumRight,
+                                  layerBuffer.getWritePointer(0), scratch.getChannel(renderRight), numSamples);
+
+    for (auto& voice : voices)
+        if (voice->isActive())
+            voice->renderNextBlock(buses, numSamples, layerBuffer);
+
+    LayerMixer::Input inputs[numMixerInputs];
+    inputs[oscillatorInput] = { oscillatorSum, oscillatorSumRight, oscillatorSumRight != nullptr };
+    inputs[subInput].left = buses.sub;
+    inputs[noiseInput].left = buses.noise;
+
+    // The sampler goes straight to the mixer, in stereo when it has a stereo image
+    if (params.samplerEnable)
+    {
+        const bool samplerStereo = samplerLayer.isStereo() && numChannels > 1;
+        float* samplerLeft = scratch.getChannel(renderLeft);
+        float* samplerRight = samplerStereo ? scratch.getChannel(renderRight) : nullptr;
+        samplerLayer.render(samplerLeft, samplerRight, numSamples);
+
+        inputs[samplerInput] = { samplerLeft, samplerRight, samplerStereo };
+    }
+
+    mixer.process(inputs, numMixerInputs,
+                  output.getWritePointer(0, startSample),
+                  numChannels > 1 ? output.getWritePointer(1, startSample) : nullptr,
+                  numSamples);
+}
+
+void SynthEngine1::renderSpan(juce::AudioBuffer<float>& output, int startSample, int numSamples)
+{
+    jassert(numSamples <= spanSize);
+
+    // Voices are retired once per span here; within the span workers only render
+    retireSilentVoices();
+
+    // Control tier for the whole span, on this thread and in tile order.
+    // Each piece keeps a copy of the snapshot its control tick produced.
+    numSpanPieces = 0;
+    for (int offset = 0; offset < numSamples;)
+    {
+        auto& piece = spanPieces[(size_t) numSpanPieces++];
+        piece.controlTick = samplesUntilControlTick == 0;
+
+        if (piece.controlTick)
+        {
+            params.update(startSample + offset + tileSize - 1);
+            piece.waveformChanged = consumeWaveformChange();
+            samplesUntilControlTick = tileSize;
+        }
+
+        piece.params = params;
+        piece.start = offset;
+        piece.length = juce::jmin(numSamples - offset, samplesUntilControlTick);
+
+        // Envelopes for the whole span, before any worker reads them
+        for (auto& envelope : envelopes)
+        {
+            if (piece.controlTick)
+                applyEnvelopeParameters(envelope, params);
+            envelope.process(piece.start, piece.length);
+        }
+
+        offset += piece.length;
+        samplesUntilControlTick -= piece.length;
+    }
+
+    spanLength = numSamples;
+    spanChannels = spanScratch.getChannels();
+    spanOutputChannels = juce::jmin(output.getNumChannels(), 2);
+    spanSamplerStereo = samplerLayer.isStereo() && spanOutputChannels > 1;
+
+    // Deal active voices round-robin into groups; idle voices only take the parameter updates
+    // At least one group, even if every voice was just retired, so the buses are always cleared
+    numVoiceGroups = juce::jlimit(1, juce::jmin(renderThreads.getNumWorkers() + 1, maxVoiceGroups), getNumActiveVoices());
+    groupSizes.fill(0);
+
+    int numAssigned = 0;
+    for (auto& voice : voices)
+    {
+        if (voice->isActive())
+        {
+            const int group = numAssigned++ % numVoiceGroups;
+            groupVoices[(size_t) group][(size_t) groupSizes[(size_t) group]++] = voice.get();
+            continue;
+        }
+
+        for (int i = 0; i < numSpanPieces; ++i)
+            if (spanPieces[(size_t) i].controlTick)
+                applyVoiceParameters(*voice, spanPieces[(size_t) i].params);
+    }
+
+    // One task per voice group plus the sampler, which doesn't depend on any voice
+    renderThreads.run([](void* context, int task)
+                      {
+                          auto& engine = *static_cast<SynthEngine1*>(context);
+                          if (task < engine.numVoiceGroups)
+                              engine.renderVoiceGroup(task);
+                          else
+                              engine.renderSamplerSpan();
+                      },
+                      this, numVoiceGroups + 1);
+
+    // Reduction and mix, in tile order on this thread
+    output.clear(startSample, numSamples);
+    const int numChannels = spanOutputChannels;
+
+    static_assert(groupSubBus - groupOscillatorBus == subInput - oscillatorInput
+                  && groupNoiseBus - groupOscillatorBus == noiseInput - oscillatorInput);
+
+    for (int i = 0; i < numSpanPieces; ++i)
+    {
+        const auto& piece = spanPieces[(size_t) i];
+        if (piece.controlTick)
+            applyMixerParameters(piece.params);
+
+        const bool busEnabled[] = { piece.params.oscEnable, piece.params.subEnable, piece.params.noiseEnable };
+        LayerMixer::Input inputs[numMixerInputs];
+
+        for (int bus = groupOscillatorBus; bus <= groupNoiseBus; ++bus)
+        {
+            if (!busEnabled[bus])
+                continue;
+
+            // Always summed in group order, whichever thread rendered each group
+            float* sum = getGroupChannel(0, bus) + piece.start;
+            for (int group = 1; group < numVoiceGroups; ++group)
+                juce::FloatVectorOperations::add(sum, getGroupChannel(group, bus) + piece.start, piece.length);
+
+            inputs[oscillatorInput + bus].left = sum;
+        }
+
+        if (isOscillatorStereo(piece.params, numChannels))
+        {
+            float* sum = getGroupChannel(0, groupOscillatorBusRight) + piece.start;
+            for (int group = 1; group < numVoiceGroups; ++group)
+                juce::FloatVectorOperations::add(sum, getGroupChannel(group, groupOscillatorBusRight) + piece.start, piece.length);
+
+            inputs[oscillatorInput].right = sum;
+            inputs[oscillatorInput].stereo = true;
         }
+
+        if (piece.params.samplerEnable)
+            inputs[samplerInput] = { getSpanSamplerChannel(0) + piece.start,
+                                     spanSamplerStereo ? getSpanSamplerChannel(1) + piece.start : nullptr,
+                                     spanSamplerStereo };
+
+        const int outputStart = startSample + piece.start;
+        mixer.process(inputs, numMixerInputs,
+                      output.getWritePointer(0, outputStart),
+                      numChannels > 1 ? output.getWritePointer(1, outputStart) : nullptr,
+                      piece.length);
     }
-    
-    // Process Sampler Layer
-    if (samplerEnable > 0.5f) {
-        layerBuffer.clear();
-        juce::AudioSourceChannelInfo layerInfo(&layerBuffer, 0, bufferToFill.numSamples);
-        samplerLayer.getNextAudioBlock(layerInfo);
-        
-        // Apply level and pan
-        for (int ch = 0; ch < bufferToFill.buffer->getNumChannels(); ++ch) {
-            float panGain = 1.0f;
-            if (bufferToFill.buffer->getNumChannels() == 2) {
-                panGain = (ch == 0) ? (1.0f - std::max(0.0f, samplerPan)) : (1.0f + std::min(0.0f, samplerPan));
+}
+
+void SynthEngine1::renderVoiceGroup(int group)
+{
+    float* oscillator = getGroupChannel(group, groupOscillatorBus);
+    float* oscillatorRight = getGroupChannel(group, groupOscillatorBusRight);
+    float* sub = getGroupChannel(group, groupSubBus);
+    float* noise = getGroupChannel(group, groupNoiseBus);
+
+    for (auto* bus : { oscillator, oscillatorRight, sub, noise })
+        juce::FloatVectorOperations::clear(bus, spanLength);
+
+    juce::AudioBuffer<float> layerBuffer(spanChannels + group * numGroupChannels + groupLayerBuffer, 1, tileSize);
+    float* layerBufferRight = getGroupChannel(group, groupLayerBufferRight);
+    const auto& groupVoiceList = groupVoices[(size_t) group];
+
+    for (int i = 0; i < numSpanPieces; ++i)
+    {
+        const auto& piece = spanPieces[(size_t) i];
+
+        for (int bank = group; bank < numOscillatorLayers; bank += numVoiceGroups)
+        {
+            auto& layer = oscillatorLayers[(size_t) bank];
+
+            if (piece.controlTick)
+            {
+                applyOscillatorParameters(layer, piece.params, piece.waveformChanged, resourceManager.getUserTable());
+                layer.controlTick();
+            }
+
+            layer.setEnvelopeFrames(envelopes[(size_t) bank].getFrames(piece.start));
+
+            if (piece.params.oscEnable)
+                renderOscillatorLayer(layer, oscillator + piece.start,
+                                      isOscillatorStereo(piece.params, spanOutputChannels) ? oscillatorRight + piece.start : nullptr,
+                                      layerBuffer.getWritePointer(0), layerBufferRight, piece.length);
+        }
+
+        SynthVoice::LayerBuses buses;
+        buses.envelopeFrame = piece.start;
+        if (piece.params.subEnable)   buses.sub = sub + piece.start;
+        if (piece.params.noiseEnable) buses.noise = noise + piece.start;
+
+        for (int v = 0; v < groupSizes[(size_t) group]; ++v)
+        {
+            auto& voice = *groupVoiceList[(size_t) v];
+
+            if (piece.controlTick)
+            {
+                applyVoiceParameters(voice, piece.params);
+                if (voice.isActive())
+                    voice.controlTick();
             }
-            bufferToFill.buffer->addFrom(ch, bufferToFill.startSample, 
-                                       layerBuffer, ch, 0, bufferToFill.numSamples, 
-                                       samplerLevel * panGain);
+
+            voice.renderNextBlock(buses, piece.length, layerBuffer);
         }
     }
 }
 
-OscillatorLayer& SynthEngine1::getOscillatorLayer() { return oscillatorLayer; }
-SubLayer& SynthEngine1::getSubLayer() { return subLayer; }
-NoiseLayer& SynthEngine1::getNoiseLayer() { return noiseLayer; }
+void SynthEngine1::renderSamplerSpan()
+{
+    float* left = getSpanSamplerChannel(0);
+    float* right = spanSamplerStereo ? getSpanSamplerChannel(1) : nullptr;
+
+    for (int i = 0; i < numSpanPieces; ++i)
+    {
+        const auto& piece = spanPieces[(size_t) i];
+        if (piece.params.samplerEnable)
+            samplerLayer.render(left + piece.start, right != nullptr ? right + piece.start : nullptr, piece.length);
+    }
+}
+
+float* SynthEngine1::getGroupChannel(int group, int channel) const
+{
+    return spanChannels[group * numGroupChannels + channel];
+}
+
+float* SynthEngine1::getSpanSamplerChannel(int side) const
+{
+    return spanChannels[spanScratch.getNumChannels() - 2 + side];
+}
+
 SamplerLayer& SynthEngine1::getSamplerLayer() { return samplerLayer; }
@@ -2,26 +2,42 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_processors/juce_audio_processors.h>
-#include "../Synth/OscillatorLayer.h"
-#include "../Synth/SubLayer.h"
-#include "../Synth/NoiseLayer.h"
 #include "../Synth/SamplerLayer.h"
+#include "../DSP/SynthVoice.h"
+#include "../DSP/ScratchArena.h"
+#include "../DSP/LayerMixer.h"
+#include "../Core/RenderThreadPool.h"
+#include "ParameterSnapshot.h"
+#include "../Resources/ResourceManager.h"
 
-class SynthEngine1 : public juce::AudioSource {
+class SynthEngine1 : public juce::AudioSource, private juce::Timer {
 public:
-    SynthEngine1(juce::AudioProcessorValueTreeState& apvts);
+    SynthEngine1(juce::AudioProcessorValueTreeState& apvts, const SmootherBank& smoothers);
     ~SynthEngine1() override;
 
     void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
     void releaseResources() override;
     void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
 
+    // Voice management - never allocates, voices are created in prepareToPlay
+    void noteOn(int midiNoteNumber, float velocity);
+    void noteOff(int midiNoteNumber);
+    void allNotesOff();
+    int getNumActiveVoices() const; // Playing or releasing
+    const SynthVoice* getVoiceForNote(int midiNoteNumber) const; // Playing or releasing, nullptr if none
+
+    // Longest a note can keep sounding after its note-off
+    double getTailLengthSeconds() const;
+
     // Layer accessors
-    OscillatorLayer& getOscillatorLayer();
-    SubLayer& getSubLayer();
-    NoiseLayer& getNoiseLayer();
     SamplerLayer& getSamplerLayer();
 
+    // Wavetable/sample import (message thread)
+    ResourceManager& getResourceManager() { return resourceManager; }
+
+    // Polyphony - size of the preallocated voice pool
+    static constexpr int maxVoices = 16;
+
     // Parameter IDs
     static constexpr const char* macroParamIDs[4] = { "macro1", "macro2", "macro3", "macro4" };
     static constexpr const char* oscWaveformID = "oscWaveform";
@@ -31,8 +47,151 @@ public:
 
 private:
     juce::AudioProcessorValueTreeState& apvts;
-    OscillatorLayer oscillatorLayer;
-    SubLayer subLayer;
-    NoiseLayer noiseLayer;
+    ParameterSnapshot params; // Parameter handles cached once at construction, floats smoothed
     SamplerLayer samplerLayer;
+    ResourceManager resourceManager;
+
+    // Scratch memory for layer rendering, one tile long: a stereo render buffer,
+    // one mono bus per voice layer and the oscillator bus's right side
+    enum ScratchChannel
+    {
+        renderLeft = 0,
+        renderRight,
+        oscillatorBus,
+        subBus,
+        noiseBus,
+        oscillatorBusRight, // Only used while the unison is spread in stereo
+        numScratchChannels
+    };
+    ScratchArena scratch;
+
+    // Level/pan for the summed layer buses and the sampler, one fused pass
+    enum MixerInput
+    {
+        oscillatorInput = 0,
+        subInput,
+        noiseInput,
+        samplerInput,
+        numMixerInputs
+    };
+    LayerMixer mixer;
+
+    // Oscillator layers of all voices as SoA banks, one SIMD lane per voice.
+    // Voice i plays in bank i / OscillatorLayer::maxVoices.
+    static_assert(maxVoices % OscillatorLayer::maxVoices == 0);
+    static constexpr int numOscillatorLayers = maxVoices / OscillatorLayer::maxVoices;
+    std::array<OscillatorLayer, numOscillatorLayers> oscillatorLayers;
+
+    // The voices' envelopes, one bank per oscillator bank with the same lanes. They
+    // are advanced on the audio thread before anything renders, so the oscillator
+    // banks and the voices' own layers can read them from any worker.
+    static_assert(EnvelopeBank::maxLanes == OscillatorLayer::maxVoices);
+    std::array<EnvelopeBank, numOscillatorLayers> envelopes;
+    static void applyEnvelopeParameters(EnvelopeBank& envelope, const ParameterSnapshot& snapshot);
+
+    // Renders one bank into the layer buffers and adds it to the buses; the right
+    // bus and buffer are nullptr for a mono render
+    static void renderOscillatorLayer(OscillatorLayer& layer, float* bus, float* busRight,
+                                      float* layerBuffer, float* layerBufferRight, int numSamples);
+
+    // Stereo unison only pays off with a stereo output
+    static bool isOscillatorStereo(const ParameterSnapshot& snapshot, int numOutputChannels);
+
+    // Preallocated voice pool
+    std::vector<std::unique_ptr<SynthVoice>> voices;
+    juce::uint32 noteOnCounter = 0;
+
+    SynthVoice* findVoiceForNote(int midiNoteNumber) const;
+    SynthVoice* findFreeVoice() const;
+    SynthVoice* findVoiceToSteal() const;
+
+    // Frees released voices whose output has decayed to silence, so they stop rendering
+    void retireSilentVoices();
+
+    // Pushes parameters flagged as changed in the current snapshot to every voice
+    void applyChangedParameters();
+
+    // The same update split by target, so worker threads can apply it to their own voices
+    static void applyVoiceParameters(SynthVoice& voice, const ParameterSnapshot& snapshot);
+    static void applyOscillatorParameters(OscillatorLayer& layer, const ParameterSnapshot& snapshot, bool waveformChanged,
+                                          const WaveTableBank::WaveTable* userTable);
+    void applyMixerParameters(const ParameterSnapshot& snapshot);
+
+    // True once after the waveform choice changed or a new user wavetable was taken over.
+    // Also hands the replaced user table back once no bank reads it anymore.
+    bool consumeWaveformChange();
+
+    // Internal tiling: control-rate work runs once per tile, audio-rate work inside it
+    static constexpr int tileSize = SynthLayer::controlTileSize;
+    int samplesUntilControlTick = 0;
+
+    // Control tier - parameter snapshot, smoothed values, per-voice modulation
+    void updateControl(int sampleOffset);
+
+    // Audio tier - renders at most tileSize samples
+    void renderTile(juce::AudioBuffer<float>& output, int startSample, int numSamples);
+
+    // Optional parallel path: the control tier for a whole span of tiles runs
+    // first, then active voices are split into groups that render the span on
+    // the worker pool next to the sampler. Oscillator bank b goes to group
+    // b % numVoiceGroups. Every group adds into its own
+    // buses; the buses are summed in group order, so the output never depends
+    // on which thread ran which group.
+    static constexpr int maxVoiceGroups = 8;
+    static constexpr int maxSpanTiles = 16;
+    static constexpr int spanSize = maxSpanTiles * tileSize;
+
+    struct SpanPiece
+    {
+        ParameterSnapshot params;     // Snapshot as of this piece
+        int start = 0;                // Offset within the span
+        int length = 0;
+        bool controlTick = false;     // Control tier ran before this piece
+        bool waveformChanged = false;
+    };
+
+    // Per-group span channels: one bus per voice layer, in MixerInput order, and a
+    // layer buffer, each followed by the right side used by stereo unison
+    enum GroupChannel
+    {
+        groupOscillatorBus = 0,
+        groupSubBus,
+        groupNoiseBus,
+        groupOscillatorBusRight,
+        groupLayerBuffer,
+        groupLayerBufferRight,
+        numGroupChannels
+    };
+
+    // Workers for the optional parallel path. They only run while "multithreading" is on:
+    // a timer on the message thread starts and stops them, and the audio thread only
+    // try-locks renderThreadsLock, rendering serially while they change.
+    RenderThreadPool renderThreads;
+    juce::SpinLock renderThreadsLock;
+    std::atomic<float>* multithreadingParam = nullptr;
+    int renderWorkers = 0; // Pool size when enabled, chosen in prepareToPlay; 0 when unprepared
+    int preparedBlockSize = 0;
+    double preparedSampleRate = 0.0;
+    ScratchArena spanScratch; // Group channels for every group, then the sampler's stereo pair
+    float* const* spanChannels = nullptr; // Resolved before each run - workers never touch the arena itself
+
+    std::vector<SpanPiece> spanPieces; // Sized in prepareToPlay: a partial tile plus maxSpanTiles
+    int numSpanPieces = 0;
+    int spanLength = 0;
+    bool spanSamplerStereo = false;
+    int spanOutputChannels = 0;
+
+    std::array<std::array<SynthVoice*, maxVoices>, maxVoiceGroups> groupVoices {};
+    std::array<int, maxVoiceGroups> groupSizes {};
+    int numVoiceGroups = 0;
+
+    // Starts or stops the workers to follow "multithreading" (message thread)
+    void updateRenderThreads();
+    void timerCallback() override { updateRenderThreads(); }
+
+    void renderSpan(juce::AudioBuffer<float>& output, int startSample, int numSamples);
+    void renderVoiceGroup(int group);
+    void renderSamplerSpan();
+    float* getGroupChannel(int group, int channel) const;
+    float* getSpanSamplerChannel(int side) const;
 };
@@ -224,25 +224,20 @@ void OrbVisualizer::pushAudioData(const juce::AudioBuffer<float>& buffer)
     }
     else
     {
-        // Mix all channels to mono
-        std::vector<const float*> channels;
-        channels.reserve(buffer.getNumChannels());
-        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-            channels.push_back(buffer.getReadPointer(ch));
+        // Mix all channels to mono in fixed-size chunks - no allocation on the audio thread
+        const int numChannels = buffer.getNumChannels();
+        const float channelScale = 1.0f / static_cast<float>(numChannels);
         
-        const int numSamples = buffer.getNumSamples();
-        std::vector<float> mixedData(numSamples, 0.0f);
-        
-        for (int i = 0; i < numSamples; ++i)
+        for (int offset = 0; offset < buffer.getNumSamples(); offset += bufferSize)
         {
-            float sum = 0.0f;
-            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-                sum += channels[ch][i];
+            const int numSamples = std::min(bufferSize, buffer.getNumSamples() - offset);
+            
+            juce::FloatVectorOperations::copyWithMultiply(monoMixBuffer.data(), buffer.getReadPointer(0, offset), channelScale, numSamples);
+            for (int ch = 1; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(monoMixBuffer.data(), buffer.getReadPointer(ch, offset), channelScale, numSamples);
             
-            mixedData[i] = sum / static_cast<float>(buffer.getNumChannels());
+            pushAudioData(monoMixBuffer.data(), numSamples);
         }
-        
-        pushAudioData(mixedData.data(), numSamples);
     }
 }
 
@@ -81,6 +81,7 @@ private:
     std::array<float, bufferSize> energyHistory;
     std::array<float, fftSize * 2> fftData;
     std::array<float, numBins> spectrumData;
+    std::array<float, bufferSize> monoMixBuffer; // Audio-thread mixdown scratch
     int writePos = 0;
     
     //==============================================================================
@@ -161,8 +161,9 @@ void SynthEngine1Panel::setupLayerControls()
     addAndMakeVisible(oscillatorLevel);
     // Tools button for oscillator layer
     oscillatorSettingsButton = std::make_unique<juce::TextButton>("⚙");
-    oscillatorSettingsButton->setTooltip("Oscillator settings");
+    oscillatorSettingsButton->setTooltip("Oscillator settings - load a user wavetable");
     oscillatorSettingsButton->setColour(juce::TextButton::buttonColourId, juce::Colours::darkgrey);
+    oscillatorSettingsButton->onClick = [this]() { chooseUserWavetable(); };
     addAndMakeVisible(*oscillatorSettingsButton);
     // Randomize button for oscillator layer
     oscillatorRandomizeButton = std::make_unique<juce::TextButton>("R");
@@ -184,6 +185,7 @@ void SynthEngine1Panel::setupLayerControls()
     oscillatorWaveform.addItem("Square", 2);
     oscillatorWaveform.addItem("Triangle", 3);
     oscillatorWaveform.addItem("Sine", 4);
+    oscillatorWaveform.addItem("User", 5);
     oscillatorWaveform.setSelectedId(1);
     oscillatorWaveform.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xFF2A2A2A));
     oscillatorWaveform.setColour(juce::ComboBox::textColourId, juce::Colours::orange);
@@ -671,3 +673,15 @@ void SynthEngine1Panel::resized()
     samplerPanLabel.setBounds(samplerPanBounds.removeFromTop(labelHeight));
     samplerPan.setBounds(samplerPanBounds.reduced(0, 2));
 }
+
+void SynthEngine1Panel::chooseUserWavetable()
+{
+    wavetableChooser = std::make_unique<juce::FileChooser>("Load Wavetable", juce::File(), "*.wav;*.aif;*.aiff;*.flac");
+    wavetableChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+        [this](const juce::FileChooser& chooser)
+        {
+            const auto file = chooser.getResult();
+            if (file.existsAsFile() && synthEngine.getResourceManager().loadWavetable(file))
+                oscillatorWaveform.setSelectedId(5); // Switch to the freshly loaded user table
+        });
+}
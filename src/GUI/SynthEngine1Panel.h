@@ -115,5 +115,9 @@ private:
     void setupLabels();
     void setupAttachments();
     
+    // User wavetable import (oscillator settings button)
+    std::unique_ptr<juce::FileChooser> wavetableChooser;
+    void chooseUserWavetable();
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SynthEngine1Panel)
 };
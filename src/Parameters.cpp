@@ -8,7 +8,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
     params.push_back(std::make_unique<juce::AudioParameterFloat>("masterVolume", "Master Volume", 0.0f, 1.0f, 0.7f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("filterCutoff", "Filter Cutoff", 20.0f, 20000.0f, 2000.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("filterResonance", "Filter Resonance", 0.1f, 10.0f, 1.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("filterKeyTrack", "Filter Key Tracking", 0.0f, 1.0f, 0.5f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("filterEnvAmount", "Filter Envelope", 0.0f, 8.0f, 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("attackTime", "Attack Time", 0.001f, 5.0f, 0.1f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("decayTime", "Decay Time", 0.001f, 10.0f, 0.5f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("sustainLevel", "Sustain Level", 0.0f, 1.0f, 1.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("releaseTime", "Release Time", 0.01f, 10.0f, 1.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("performanceX", "Performance X", 0.0f, 1.0f, 0.5f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("performanceY", "Performance Y", 0.0f, 1.0f, 0.5f));
@@ -20,6 +24,22 @@ juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
     
     // Industrial Effects
     params.push_back(std::make_unique<juce::AudioParameterFloat>("distortion", "Industrial Distortion", 0.0f, 10.0f, 2.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("distortionMix", "Distortion Mix", 0.0f, 1.0f, 0.0f)); // 0 bypasses the stage
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("distortionShape", "Distortion Shape", juce::StringArray{"Tanh", "Hard Clip", "Foldback"}, 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("distortionAntialiasing", "Distortion Antialiasing", juce::StringArray{"ADAA 1st Order", "ADAA 2nd Order"}, 1));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("distortionOversampling", "Distortion Oversampling", juce::StringArray{"1x", "2x", "4x", "8x"}, 1));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("oversamplingQuality", "Oversampling Quality", juce::StringArray{"Polyphase IIR", "Linear Phase FIR"}, 0)); // Shared by every oversampled stage
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("delayTime", "Delay Time", 0.01f, 2.0f, 0.375f)); // Seconds, unless synced
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("delaySync", "Delay Sync", juce::StringArray{"Off", "1/4", "1/8", "1/8 Dotted", "1/8 Triplet", "1/16"}, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("delayFeedback", "Delay Feedback", 0.0f, 1.0f, 0.4f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("delayMix", "Delay Mix", 0.0f, 1.0f, 0.0f)); // 0 bypasses the stage
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("delayMode", "Delay Mode", juce::StringArray{"Tape", "Ping-Pong"}, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("delayWow", "Delay Wow & Flutter", 0.0f, 1.0f, 0.2f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("reverbSize", "Reverb Size", 0.0f, 1.0f, 0.5f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("reverbDamp", "Reverb Damping", 0.0f, 1.0f, 0.3f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("reverbMix", "Reverb Mix", 0.0f, 1.0f, 0.0f)); // 0 bypasses the stage
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("reverbShimmer", "Reverb Shimmer", 0.0f, 1.0f, 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("reverbMode", "Reverb Mode", juce::StringArray{"Algorithmic", "Convolution"}, 0)); // Convolution uses the loaded impulse response
     
     // Macros - Advanced modulation system
     params.push_back(std::make_unique<juce::AudioParameterFloat>("macroTension", "Tension", 0.0f, 1.0f, 0.5f));
@@ -38,9 +58,14 @@ juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
     params.push_back(std::make_unique<juce::AudioParameterBool>("osc1Enable", "Oscillator Enable", true));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("osc1Level", "Oscillator Level", 0.0f, 1.0f, 0.7f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("osc1Pan", "Oscillator Pan", -1.0f, 1.0f, 0.0f));
-    params.push_back(std::make_unique<juce::AudioParameterChoice>("osc1Waveform", "Oscillator Waveform", juce::StringArray{"Saw", "Square", "Triangle", "Sine"}, 2)); // Default to Triangle
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("osc1Waveform", "Oscillator Waveform", juce::StringArray{"Saw", "Square", "Triangle", "Sine", "User"}, 2)); // Default to Triangle, User = imported wavetable
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("osc1Mode", "Oscillator Mode", juce::StringArray{"Wavetable", "Analytic"}, 0)); // Analytic = table-free PolyBLEP
     params.push_back(std::make_unique<juce::AudioParameterFloat>("osc1Detune", "Oscillator Detune", -50.0f, 50.0f, 5.0f)); // Default 5 cents detune
     params.push_back(std::make_unique<juce::AudioParameterFloat>("osc1Octave", "Oscillator Octave", -3.0f, 3.0f, 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterInt>("osc1Unison", "Oscillator Unison", 1, 16, 3)); // Oscillators per voice, spread by osc1Detune
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("osc1DetuneCurve", "Oscillator Detune Curve", 0.0f, 1.0f, 0.0f)); // 0 = even spacing, 1 = supersaw-style
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("osc1Spread", "Oscillator Stereo Spread", 0.0f, 1.0f, 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("osc1PhaseRandom", "Oscillator Phase Randomness", 0.0f, 1.0f, 0.0f));
     
     // Sub Oscillator Layer - Enable for ambient pads
     params.push_back(std::make_unique<juce::AudioParameterBool>("subEnable", "Sub Oscillator Enable", true));
@@ -61,5 +86,8 @@ juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
     params.push_back(std::make_unique<juce::AudioParameterFloat>("samplerLevel", "Sampler Level", 0.0f, 1.0f, 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("samplerPan", "Sampler Pan", -1.0f, 1.0f, 0.0f));
     
+    // Engine
+    params.push_back(std::make_unique<juce::AudioParameterBool>("multithreading", "Multithreaded Rendering", false)); // Voices rendered on worker threads
+    
     return { params.begin(), params.end() };
 }
@@ -165,6 +165,30 @@ VoidTextureSynthAudioProcessorEditor::VoidTextureSynthAudioProcessorEditor (Void
         audioProcessor.apvts, "macro3", macro3Slider);
     macro4Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.apvts, "macro4", macro4Slider);
+
+    // Connect FX module knobs to parameters
+    filterCutoffAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "filterCutoff", filterCutoffSlider);
+    filterResonanceAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "filterResonance", filterResonanceSlider);
+    distortionDriveAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "distortion", distortionDriveSlider);
+    distortionMixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "distortionMix", distortionMixSlider);
+    reverbSizeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "reverbSize", reverbSizeSlider);
+    reverbDampAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "reverbDamp", reverbDampSlider);
+    reverbMixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "reverbMix", reverbMixSlider);
+    reverbModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.apvts, "reverbMode", reverbModeBox);
+    delayTimeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "delayTime", delayTimeSlider);
+    delayFeedbackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "delayFeedback", delayFeedbackSlider);
+    delayMixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "delayMix", delayMixSlider);
     
     // Setup synth2 label (placeholder for future)
     synth2Label.setText("SYNTH ENGINE 2\n\nReserved for Future Expansion", juce::dontSendNotification);
@@ -742,9 +766,15 @@ void VoidTextureSynthAudioProcessorEditor::layoutFXSectionWithFlexBox(juce::Rect
     
     // Layout FX modules only if their components are visible
     if (reverbLabel.isVisible())
-        layoutFXModuleWithFlexBox(modules[0], reverbLabel, reverbSizeSlider, reverbDampSlider, reverbSizeLabel, reverbDampLabel, "REVERB");
+    {
+        layoutFXModuleWithFlexBox(modules[0], reverbLabel, reverbSizeSlider, reverbDampSlider, reverbSizeLabel, reverbDampLabel, "REVERB",
+                                  &reverbMixSlider, &reverbMixLabel);
+        reverbModeBox.setBounds(modules[0].getX() + 4, modules[0].getY() + 2, 56, 16);
+        reverbLoadButton.setBounds(modules[0].getRight() - 52, modules[0].getY() + 2, 48, 16);
+    }
     if (delayLabel.isVisible())
-        layoutFXModuleWithFlexBox(modules[1], delayLabel, delayTimeSlider, delayFeedbackSlider, delayTimeLabel, delayFeedbackLabel, "DELAY");
+        layoutFXModuleWithFlexBox(modules[1], delayLabel, delayTimeSlider, delayFeedbackSlider, delayTimeLabel, delayFeedbackLabel, "DELAY",
+                                  &delayMixSlider, &delayMixLabel);
     if (filterLabel.isVisible())
         layoutFXModuleWithFlexBox(modules[2], filterLabel, filterCutoffSlider, filterResonanceSlider, filterCutoffLabel, filterResonanceLabel, "FILTER");
     if (distortionLabel.isVisible())
@@ -757,7 +787,9 @@ void VoidTextureSynthAudioProcessorEditor::layoutFXModuleWithFlexBox(juce::Recta
                                                                    juce::Slider& slider2,
                                                                    juce::Label& label1,
                                                                    juce::Label& label2,
-                                                                   const juce::String& title)
+                                                                   const juce::String& title,
+                                                                   juce::Slider* slider3,
+                                                                   juce::Label* label3)
 {
     // Ensure bounds are valid
     if (bounds.getWidth() < 50 || bounds.getHeight() < 50)
@@ -773,9 +805,9 @@ void VoidTextureSynthAudioProcessorEditor::layoutFXModuleWithFlexBox(juce::Recta
     // Control area with padding
     bounds.reduce(6, 4);
     
-    // Horizontal layout for two controls
-    int controlWidth = (bounds.getWidth() - 8) / 2;
-    int controlHeight = bounds.getHeight();
+    // Horizontal layout for two controls, or three when a mix knob is given
+    const int numControls = (slider3 != nullptr && label3 != nullptr) ? 3 : 2;
+    int controlWidth = (bounds.getWidth() - 8 * (numControls - 1)) / numControls;
     
     // Left control
     auto leftBounds = bounds.removeFromLeft(controlWidth);
@@ -789,14 +821,25 @@ void VoidTextureSynthAudioProcessorEditor::layoutFXModuleWithFlexBox(juce::Recta
     // Spacing
     bounds.removeFromLeft(8);
     
-    // Right control  
-    auto rightBounds = bounds;
+    // Middle or right control
+    auto rightBounds = numControls == 3 ? bounds.removeFromLeft(controlWidth) : bounds;
     auto rightKnobBounds = rightBounds.removeFromTop(rightBounds.getHeight() - 16);
     auto rightLabelBounds = rightBounds;
     
     slider2.setBounds(rightKnobBounds);
     label2.setBounds(rightLabelBounds);
     label2.setJustificationType(juce::Justification::centred);
+    
+    if (numControls == 3)
+    {
+        bounds.removeFromLeft(8);
+        
+        // Right control
+        auto thirdKnobBounds = bounds.removeFromTop(bounds.getHeight() - 16);
+        slider3->setBounds(thirdKnobBounds);
+        label3->setBounds(bounds);
+        label3->setJustificationType(juce::Justification::centred);
+    }
 }
 
 void VoidTextureSynthAudioProcessorEditor::layoutMacroSectionWithFlexBox(juce::Rectangle<int> bounds)
@@ -926,8 +969,12 @@ void VoidTextureSynthAudioProcessorEditor::layoutFXSection(juce::Rectangle<int>
     };
     
     // Layout each FX module
-    layoutFXModule(modules[0], reverbLabel, reverbSizeSlider, reverbDampSlider, reverbSizeLabel, reverbDampLabel, "REVERB");
-    layoutFXModule(modules[1], delayLabel, delayTimeSlider, delayFeedbackSlider, delayTimeLabel, delayFeedbackLabel, "DELAY");
+    layoutFXModule(modules[0], reverbLabel, reverbSizeSlider, reverbDampSlider, reverbSizeLabel, reverbDampLabel, "REVERB",
+                   &reverbMixSlider, &reverbMixLabel);
+    reverbModeBox.setBounds(modules[0].getX() + 2, modules[0].getY() + 1, 46, 12);
+    reverbLoadButton.setBounds(modules[0].getRight() - 44, modules[0].getY() + 1, 42, 12);
+    layoutFXModule(modules[1], delayLabel, delayTimeSlider, delayFeedbackSlider, delayTimeLabel, delayFeedbackLabel, "DELAY",
+                   &delayMixSlider, &delayMixLabel);
     layoutFXModule(modules[2], filterLabel, filterCutoffSlider, filterResonanceSlider, filterCutoffLabel, filterResonanceLabel, "FILTER");
     layoutFXModule(modules[3], distortionLabel, distortionDriveSlider, distortionMixSlider, distortionDriveLabel, distortionMixLabel, "DISTORTION");
 }
@@ -983,7 +1030,8 @@ void VoidTextureSynthAudioProcessorEditor::layoutFXModule(juce::Rectangle<int> b
                                                           juce::Label& headerLabel,
                                                           juce::Slider& slider1, juce::Slider& slider2,
                                                           juce::Label& label1, juce::Label& label2,
-                                                          const juce::String& title)
+                                                          const juce::String& title,
+                                                          juce::Slider* slider3, juce::Label* label3)
 {
     // Temporary method - will use 6-control version once all controls are added
     // For now, use the existing 2-control layout but make it more compact
@@ -1013,6 +1061,14 @@ void VoidTextureSynthAudioProcessorEditor::layoutFXModule(juce::Rectangle<int> b
     
     slider2.setBounds(x2, y, knobSize, knobSize);
     label2.setBounds(x2, y + knobSize + 1, knobSize, labelHeight);
+    
+    // Optional third control fills the last column of the row
+    if (slider3 != nullptr && label3 != nullptr)
+    {
+        int x3 = controlArea.getX() + 2 * knobWidth + (knobWidth - knobSize) / 2;
+        slider3->setBounds(x3, y, knobSize, knobSize);
+        label3->setBounds(x3, y + knobSize + 1, knobSize, labelHeight);
+    }
 }
 
 void VoidTextureSynthAudioProcessorEditor::layoutMacroSection(juce::Rectangle<int> area)
@@ -1086,6 +1142,28 @@ void VoidTextureSynthAudioProcessorEditor::displayModeButtonClicked()
     }
 }
 
+void VoidTextureSynthAudioProcessorEditor::chooseImpulseResponse()
+{
+    impulseChooser = std::make_unique<juce::FileChooser>("Load Impulse Response", juce::File(), "*.wav;*.aif;*.aiff;*.flac");
+    impulseChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+        [this](const juce::FileChooser& chooser)
+        {
+            const auto file = chooser.getResult();
+            if (! file.existsAsFile())
+                return;
+
+            // Decoding and partitioning a long response takes a while, so it runs in the background
+            auto& resources = audioProcessor.synthEngine1.getResourceManager();
+            resources.loadImpulseResponseAsync(file, audioProcessor.effects.getConvolutionReverb(),
+                [safeThis = juce::Component::SafePointer<VoidTextureSynthAudioProcessorEditor>(this)](bool loaded)
+                {
+                    // Through the attached box, so the host sees a complete change gesture
+                    if (safeThis != nullptr && loaded)
+                        safeThis->reverbModeBox.setSelectedId(2, juce::sendNotificationSync); // CONV
+                });
+        });
+}
+
 void VoidTextureSynthAudioProcessorEditor::setupFXControls()
 {
     // Reverb Controls
@@ -1101,6 +1179,12 @@ void VoidTextureSynthAudioProcessorEditor::setupFXControls()
     reverbDampSlider.setValue(0.3);
     contentArea.addAndMakeVisible(reverbDampSlider);
     
+    reverbMixSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    reverbMixSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    reverbMixSlider.setRange(0.0, 1.0, 0.01);
+    reverbMixSlider.setValue(0.0);
+    contentArea.addAndMakeVisible(reverbMixSlider);
+    
     reverbSizeLabel.setText("SIZE", juce::dontSendNotification);
     reverbSizeLabel.setFont(juce::Font(10.0f, juce::Font::bold));
     reverbSizeLabel.setColour(juce::Label::textColourId, juce::Colours::white);
@@ -1113,25 +1197,50 @@ void VoidTextureSynthAudioProcessorEditor::setupFXControls()
     reverbDampLabel.setJustificationType(juce::Justification::centred);
     contentArea.addAndMakeVisible(reverbDampLabel);
     
+    reverbMixLabel.setText("MIX", juce::dontSendNotification);
+    reverbMixLabel.setFont(juce::Font(10.0f, juce::Font::bold));
+    reverbMixLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    reverbMixLabel.setJustificationType(juce::Justification::centred);
+    contentArea.addAndMakeVisible(reverbMixLabel);
+    
     reverbLabel.setText("REVERB", juce::dontSendNotification);
     reverbLabel.setFont(juce::Font(12.0f, juce::Font::bold));
     reverbLabel.setColour(juce::Label::textColourId, juce::Colours::white);
     reverbLabel.setJustificationType(juce::Justification::centred);
     contentArea.addAndMakeVisible(reverbLabel);
+
+    // Item IDs follow the "reverbMode" choices, as the attachment expects
+    reverbModeBox.addItem("ALGO", 1);
+    reverbModeBox.addItem("CONV", 2);
+    reverbModeBox.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xFF2A2A33));
+    reverbModeBox.setColour(juce::ComboBox::textColourId, juce::Colours::white);
+    contentArea.addAndMakeVisible(reverbModeBox);
+
+    reverbLoadButton.setButtonText("LOAD IR");
+    reverbLoadButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xFF2A2A33));
+    reverbLoadButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    reverbLoadButton.onClick = [this] { chooseImpulseResponse(); };
+    contentArea.addAndMakeVisible(reverbLoadButton);
     
     // Delay Controls
     delayTimeSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     delayTimeSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    delayTimeSlider.setRange(0.0, 1.0, 0.01);
-    delayTimeSlider.setValue(0.25);
+    delayTimeSlider.setRange(0.01, 2.0, 0.01);
+    delayTimeSlider.setValue(0.375);
     contentArea.addAndMakeVisible(delayTimeSlider);
     
     delayFeedbackSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     delayFeedbackSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    delayFeedbackSlider.setRange(0.0, 0.95, 0.01);
+    delayFeedbackSlider.setRange(0.0, 1.0, 0.01);
     delayFeedbackSlider.setValue(0.4);
     contentArea.addAndMakeVisible(delayFeedbackSlider);
     
+    delayMixSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    delayMixSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    delayMixSlider.setRange(0.0, 1.0, 0.01);
+    delayMixSlider.setValue(0.0);
+    contentArea.addAndMakeVisible(delayMixSlider);
+    
     delayTimeLabel.setText("TIME", juce::dontSendNotification);
     delayTimeLabel.setFont(juce::Font(10.0f, juce::Font::bold));
     delayTimeLabel.setColour(juce::Label::textColourId, juce::Colours::white);
@@ -1144,6 +1253,12 @@ void VoidTextureSynthAudioProcessorEditor::setupFXControls()
     delayFeedbackLabel.setJustificationType(juce::Justification::centred);
     contentArea.addAndMakeVisible(delayFeedbackLabel);
     
+    delayMixLabel.setText("MIX", juce::dontSendNotification);
+    delayMixLabel.setFont(juce::Font(10.0f, juce::Font::bold));
+    delayMixLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    delayMixLabel.setJustificationType(juce::Justification::centred);
+    contentArea.addAndMakeVisible(delayMixLabel);
+    
     delayLabel.setText("DELAY", juce::dontSendNotification);
     delayLabel.setFont(juce::Font(12.0f, juce::Font::bold));
     delayLabel.setColour(juce::Label::textColourId, juce::Colours::white);
@@ -1153,7 +1268,7 @@ void VoidTextureSynthAudioProcessorEditor::setupFXControls()
     // Distortion Controls
     distortionDriveSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     distortionDriveSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    distortionDriveSlider.setRange(1.0, 10.0, 0.1);
+    distortionDriveSlider.setRange(0.0, 10.0, 0.1);
     distortionDriveSlider.setValue(2.0);
     contentArea.addAndMakeVisible(distortionDriveSlider);
     
@@ -1288,15 +1403,21 @@ void VoidTextureSynthAudioProcessorEditor::setFXControlsVisible(bool visible)
     // Reverb controls
     reverbSizeSlider.setVisible(visible);
     reverbDampSlider.setVisible(visible);
+    reverbMixSlider.setVisible(visible);
     reverbSizeLabel.setVisible(visible);
     reverbDampLabel.setVisible(visible);
+    reverbMixLabel.setVisible(visible);
     reverbLabel.setVisible(visible);
+    reverbModeBox.setVisible(visible);
+    reverbLoadButton.setVisible(visible);
     
     // Delay controls
     delayTimeSlider.setVisible(visible);
     delayFeedbackSlider.setVisible(visible);
+    delayMixSlider.setVisible(visible);
     delayTimeLabel.setVisible(visible);
     delayFeedbackLabel.setVisible(visible);
+    delayMixLabel.setVisible(visible);
     delayLabel.setVisible(visible);
     
     // Distortion controls
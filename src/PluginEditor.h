@@ -39,7 +39,8 @@ private:
                         juce::Label& headerLabel,
                         juce::Slider& slider1, juce::Slider& slider2,
                         juce::Label& label1, juce::Label& label2,
-                        const juce::String& title);
+                        const juce::String& title,
+                        juce::Slider* slider3 = nullptr, juce::Label* label3 = nullptr);
     void layoutFXModule6Controls(juce::Rectangle<int> bounds, 
                                 juce::Label& headerLabel,
                                 std::vector<juce::Slider*> sliders,
@@ -66,7 +67,8 @@ private:
                                   juce::Label& headerLabel,
                                   juce::Slider& slider1, juce::Slider& slider2,
                                   juce::Label& label1, juce::Label& label2,
-                                  const juce::String& title);
+                                  const juce::String& title,
+                                  juce::Slider* slider3 = nullptr, juce::Label* label3 = nullptr);
     // Simple tab buttons - no lambdas, no complex setup
     juce::TextButton mainTabButton;
     juce::TextButton synth1TabButton;
@@ -85,11 +87,14 @@ private:
     juce::Label fxLabel;
     // FX Module Controls - 6 controllers each for professional control
     // Reverb FX (6 controls)
-    juce::Slider reverbSizeSlider, reverbDampSlider, reverbWidthSlider;
+    juce::Slider reverbSizeSlider, reverbDampSlider, reverbMixSlider;
     juce::Slider reverbPreDelaySlider, reverbLowCutSlider, reverbHighCutSlider;
-    juce::Label reverbSizeLabel, reverbDampLabel, reverbWidthLabel;
+    juce::Label reverbSizeLabel, reverbDampLabel, reverbMixLabel;
     juce::Label reverbPreDelayLabel, reverbLowCutLabel, reverbHighCutLabel;
     juce::Label reverbLabel;
+    juce::ComboBox reverbModeBox; // Algorithmic or convolution
+    juce::TextButton reverbLoadButton; // Loads an impulse response and switches to convolution
+    std::unique_ptr<juce::FileChooser> impulseChooser;
     
     // Delay FX (6 controls)
     juce::Slider delayTimeSlider, delayFeedbackSlider, delayMixSlider;
@@ -155,6 +160,19 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> macro2Attachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> macro3Attachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> macro4Attachment;
+
+    // FX module parameter attachments
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterCutoffAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterResonanceAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> distortionDriveAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> distortionMixAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbSizeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbDampAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbMixAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> reverbModeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> delayTimeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> delayFeedbackAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> delayMixAttachment;
     
     // Custom look and feel for cosmic aesthetic
     VoidLookAndFeel voidLookAndFeel;
@@ -168,6 +186,7 @@ private:
     
     // Button handlers
     void displayModeButtonClicked();
+    void chooseImpulseResponse();
     
     VoidTextureSynthAudioProcessor& audioProcessor;
 
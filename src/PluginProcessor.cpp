@@ -4,6 +4,7 @@
 #include "PluginEditor.h"
 #include "Parameters.h"
 #include "GUI/OrbVisualizer.h"
+#include "Core/AllocationGuard.h"
 
 void VoidTextureSynthAudioProcessor::setOscPreset(int idx)
 {
@@ -23,8 +24,11 @@ VoidTextureSynthAudioProcessor::VoidTextureSynthAudioProcessor()
     ),
 #endif
     apvts(*this, nullptr, "Parameters", createParameterLayout()),
-    synthEngine1(apvts) // Initialize synthEngine1 with apvts
+    smoothers(apvts),
+    effects(apvts, smoothers),
+    synthEngine1(apvts, smoothers) // Initialize synthEngine1 with apvts
 {
+    masterVolumeIndex = smoothers.getIndex("masterVolume");
     // DSP engines will be initialized here once implemented
 }
 
@@ -70,7 +74,7 @@ bool VoidTextureSynthAudioProcessor::isMidiEffect() const
 
 double VoidTextureSynthAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return synthEngine1.getTailLengthSeconds() + effects.getTailLengthSeconds();
 }
 
 int VoidTextureSynthAudioProcessor::getNumPrograms()
@@ -102,17 +106,24 @@ void VoidTextureSynthAudioProcessor::changeProgramName (int index, const juce::S
 //==============================================================================
 void VoidTextureSynthAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    juce::ignoreUnused (samplesPerBlock);
     currentSampleRate = static_cast<float>(sampleRate);
     
+    // Smoothers first - the engine reads them from its first block on
+    smoothers.prepare(sampleRate, samplesPerBlock);
+
     // Initialize the enhanced synthesis engine
     synthEngine1.prepareToPlay(samplesPerBlock, sampleRate);
+
+    // Builds every oversampling setting, so the latency reported here only changes with a factor
+    // or when the distortion leaves bypass
+    effects.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+    effects.setNonRealtime(isNonRealtime());
+    setLatencySamples(effects.getLatencySamples());
     
     // Legacy oscillator initialization (can be removed later)
     oscPhase = 0.0f;
     oscFrequency = 220.0f;
     oscPhaseDelta = juce::MathConstants<float>::twoPi * oscFrequency / currentSampleRate;
-    midiNote = -1;
     // 10 example oscillator presets
     oscPresets = {
         {"Init Sine", 0, 0.0f, 0.8f},
@@ -156,73 +167,116 @@ bool VoidTextureSynthAudioProcessor::isBusesLayoutSupported (const BusesLayout&
 }
 #endif
 
+void VoidTextureSynthAudioProcessor::handleMidiEvent (const juce::MidiMessage& msg)
+{
+    // Every note gets its own voice from the engine's pool
+    if (msg.isNoteOn())
+    {
+        synthEngine1.noteOn(msg.getNoteNumber(), msg.getFloatVelocity());
+        
+        // Update MIDI activity status
+        currentMidiVelocity = msg.getFloatVelocity(); // normalized 0-1
+    }
+    else if (msg.isNoteOff())
+    {
+        synthEngine1.noteOff(msg.getNoteNumber());
+    }
+    else if (msg.isAllNotesOff() || msg.isAllSoundOff())
+    {
+        synthEngine1.allNotesOff();
+    }
+}
+
+void VoidTextureSynthAudioProcessor::applyMasterVolume (juce::AudioBuffer<float>& buffer)
+{
+    if (! smoothers.isSmoothing(masterVolumeIndex))
+    {
+        buffer.applyGain(smoothers.getTargetValue(masterVolumeIndex));
+        return;
+    }
+
+    // Hosts may exceed the announced block size, so ramp in buffer-sized pieces
+    const int numSamples = buffer.getNumSamples();
+    const int maxRamp = smoothers.getMaximumBlockSize();
+    for (int offset = 0; offset < numSamples; offset += maxRamp)
+    {
+        const int n = juce::jmin(maxRamp, numSamples - offset);
+        const float* ramp = smoothers.getRamp(masterVolumeIndex, offset, n);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            juce::FloatVectorOperations::multiply(buffer.getWritePointer(ch, offset), ramp, n);
+    }
+}
+
 void VoidTextureSynthAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    const ScopedNoAllocation noAllocation; // Guarded Standalone builds assert on audio-thread allocations
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    // MIDI note handling
-    for (const auto meta : midiMessages)
+    // Clear any output channels that didn't contain input data
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    // --- Enhanced Multi-Layer Ambient Pad Synthesis ---
+    // Render sub-blocks between MIDI events so note timing is sample-accurate
+    // regardless of the host block size
+    const int numSamples = buffer.getNumSamples();
+    smoothers.beginBlock(numSamples);
+
+    // Asleep: no voice left and the effect tails have already decayed, so skip the whole chain
+    if (midiMessages.isEmpty() && synthEngine1.getNumActiveVoices() == 0 && effects.isIdle())
     {
-        const auto msg = meta.getMessage();
-        if (msg.isNoteOn())
-        {
-            midiNote = msg.getNoteNumber();
-            oscPhase = 0.0f;
-            
-            // Update MIDI activity status
-            isNoteActive = true;
-            currentMidiVelocity = msg.getFloatVelocity(); // normalized 0-1
-        }
-        else if (msg.isNoteOff())
+        buffer.clear();
+        isNoteActive = false;
+
+        if (currentWaveformDisplay != nullptr)
         {
-            if (msg.getNoteNumber() == midiNote)
-            {
-                midiNote = -1;
-                
-                // Update MIDI activity status
-                isNoteActive = false;
-                // Don't reset velocity here - let it decay naturally in the visualizer
-            }
+            currentWaveformDisplay->pushAudioData(buffer);
+            currentWaveformDisplay->setMidiActivity(isNoteActive, currentMidiVelocity);
         }
+        return;
     }
 
-    // Clear any output channels that didn't contain input data
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
+    int renderPosition = 0;
 
-    // --- Enhanced Multi-Layer Ambient Pad Synthesis ---
-    // Update layer frequencies and activation based on MIDI note
-    if (midiNote >= 0)
+    for (const auto meta : midiMessages)
     {
-        float baseFreq = juce::MidiMessage::getMidiNoteInHertz(midiNote);
-        
-        // Update all layers with the base frequency and activate them
-        synthEngine1.getOscillatorLayer().setFrequency(baseFreq);
-        synthEngine1.getOscillatorLayer().setActive(true);
-        
-        synthEngine1.getSubLayer().setFrequency(baseFreq * 0.5f); // Sub octave
-        synthEngine1.getSubLayer().setActive(true); // Activate sub layer
-        
-        synthEngine1.getNoiseLayer().setActive(true); // Activate noise layer
-        
-        // Process the enhanced synthesis engine
-        juce::AudioSourceChannelInfo channelInfo(&buffer, 0, buffer.getNumSamples());
-        synthEngine1.getNextAudioBlock(channelInfo);
-        
-        // Apply master volume to the final output
-        float masterVolume = *apvts.getRawParameterValue("masterVolume");
-        buffer.applyGain(masterVolume);
+        const int eventPosition = juce::jlimit(0, numSamples, meta.samplePosition);
+        if (eventPosition > renderPosition)
+        {
+            juce::AudioSourceChannelInfo channelInfo(&buffer, renderPosition, eventPosition - renderPosition);
+            synthEngine1.getNextAudioBlock(channelInfo);
+            renderPosition = eventPosition;
+        }
+
+        handleMidiEvent(meta.getMessage());
     }
-    else
+
+    if (renderPosition < numSamples)
     {
-        // No MIDI note active - deactivate layers and clear buffer
-        synthEngine1.getOscillatorLayer().setActive(false);
-        synthEngine1.getSubLayer().setActive(false); // Deactivate sub layer
-        synthEngine1.getNoiseLayer().setActive(false); // Deactivate noise layer
-        buffer.clear();
+        juce::AudioSourceChannelInfo channelInfo(&buffer, renderPosition, numSamples - renderPosition);
+        synthEngine1.getNextAudioBlock(channelInfo);
     }
+
+    // Update MIDI activity status
+    // Don't reset velocity when notes end - let it decay naturally in the visualizer
+    isNoteActive = synthEngine1.getNumActiveVoices() > 0;
+
+    // Synced delay times follow the host tempo
+    if (auto* playHead = getPlayHead())
+        if (const auto position = playHead->getPosition())
+            if (const auto bpm = position->getBpm())
+                effects.setTempo(*bpm);
+
+    effects.process(buffer);
+
+    // A new oversampling factor or a distortion switched in or out changes the chain's latency; tell the host
+    if (effects.getLatencySamples() != getLatencySamples())
+        setLatencySamples(effects.getLatencySamples());
+    
+    // Apply master volume to the final output
+    applyMasterVolume(buffer);
     
     // Update waveform display if connected
     if (currentWaveformDisplay != nullptr)
@@ -4,6 +4,8 @@
 #pragma once
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "Engines/SynthEngine1.h"
+#include "Core/SmootherBank.h"
+#include "DSP/FX/EffectChain.h"
 
 // Forward declarations
 class OrbVisualizer;
@@ -14,6 +16,9 @@ class VoidTextureSynthAudioProcessor : public juce::AudioProcessor
 public:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     juce::AudioProcessorValueTreeState apvts;
+    SmootherBank smoothers; // Per-sample ramps for every float parameter, advanced once per block
+    EffectChain effects; // Master effects between the engine and the master volume; outlives the engine,
+                         // whose ResourceManager loads impulse responses into it in the background
     SynthEngine1 synthEngine1; // Instantiate SynthEngine1
     
     // Audio visualization
@@ -29,7 +34,6 @@ public:
     float oscPhase = 0.0f;
     float oscFrequency = 220.0f;
     float oscPhaseDelta = 0.0f;
-    int midiNote = -1;
     int oscPresetIndex = 0;
     struct OscPreset {
         juce::String name;
@@ -70,5 +74,13 @@ public:
     void setStateInformation (const void*, int) override;
 
 private:
+    int masterVolumeIndex = -1; // Smoother index, resolved once
+
+    // Applies the smoothed master volume, per sample only while it is moving
+    void applyMasterVolume (juce::AudioBuffer<float>& buffer);
+
+    // Applies a single MIDI event at the current render position
+    void handleMidiEvent (const juce::MidiMessage& msg);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoidTextureSynthAudioProcessor)
 };
@@ -1,12 +1,161 @@
-#include <juce_core/juce_core.h>
+#include "ResourceManager.h"
+#include <juce_events/juce_events.h>
 
-class ResourceManager {
+// Sleeps until a request arrives, so an instance that never loads a response costs nothing
+class ResourceManager::ImpulseLoader : public juce::Thread
+{
 public:
-    ResourceManager() {}
-    void loadWavetable(const juce::File& file) {
-        // Load wavetable from file
+    explicit ImpulseLoader(ResourceManager& owner)
+        : juce::Thread("Impulse Loader"),
+          resources(owner)
+    {
     }
-    void loadSample(const juce::File& file) {
-        // Load sample from file
+
+    ~ImpulseLoader() override
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread(10000); // A long response takes a moment to finish building
+    }
+
+    void request(const juce::File& file, ConvolutionReverb& destination, std::function<void(bool)> onFinished)
+    {
+        {
+            const juce::CriticalSection::ScopedLockType lock(requestLock);
+            pending = { file, &destination, std::move(onFinished) };
+        }
+
+        if (!isThreadRunning())
+            startThread(juce::Thread::Priority::background);
+
+        notify();
     }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            Request next;
+            {
+                const juce::CriticalSection::ScopedLockType lock(requestLock);
+                std::swap(next, pending);
+            }
+
+            if (next.destination == nullptr)
+            {
+                wait(-1);
+                continue;
+            }
+
+            const bool loaded = resources.loadImpulseResponse(next.file, *next.destination);
+            if (next.onFinished != nullptr)
+                juce::MessageManager::callAsync([onFinished = std::move(next.onFinished), loaded] { onFinished(loaded); });
+        }
+    }
+
+private:
+    struct Request
+    {
+        juce::File file;
+        ConvolutionReverb* destination = nullptr;
+        std::function<void(bool)> onFinished;
+    };
+
+    ResourceManager& resources;
+    juce::CriticalSection requestLock;
+    Request pending;
 };
+
+ResourceManager::ResourceManager()
+{
+    formatManager.registerBasicFormats();
+}
+
+ResourceManager::~ResourceManager()
+{
+    impulseLoader.reset();
+
+    delete pendingUserTable.exchange(nullptr);
+    delete retiredUserTable.exchange(nullptr);
+    delete outgoingUserTable;
+    delete userTable;
+}
+
+bool ResourceManager::loadWavetable(const juce::File& file)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples < 2)
+        return false;
+
+    // Multi-frame wavetables are stored as consecutive cycles - use the first one
+    const int numSamples = (int) juce::jmin<juce::int64>(reader->lengthInSamples, WaveTableBank::tableSize);
+
+    juce::AudioBuffer<float> cycle(1, numSamples);
+    if (!reader->read(&cycle, 0, numSamples, 0, true, false))
+        return false;
+
+    auto table = WaveTableBank::createUserTable(cycle.getReadPointer(0), numSamples);
+    if (table == nullptr)
+        return false;
+
+    // The audio thread let go of the retired table before handing it back. A pending
+    // table it never picked up is replaced - the audio thread only ever sees the newest.
+    delete retiredUserTable.exchange(nullptr, std::memory_order_acquire);
+    delete pendingUserTable.exchange(table.release(), std::memory_order_acq_rel);
+    return true;
+}
+
+bool ResourceManager::takeUserTable()
+{
+    if (outgoingUserTable != nullptr)
+        return false;
+
+    auto* table = pendingUserTable.exchange(nullptr, std::memory_order_acq_rel);
+    if (table == nullptr)
+        return false;
+
+    outgoingUserTable = userTable;
+    userTable = table;
+    return true;
+}
+
+void ResourceManager::retireOutgoingUserTable()
+{
+    // The retired slot holds one table; if the last one hasn't been freed yet, try again next tick
+    WaveTable* expected = nullptr;
+    if (outgoingUserTable != nullptr
+        && retiredUserTable.compare_exchange_strong(expected, outgoingUserTable, std::memory_order_release))
+        outgoingUserTable = nullptr;
+}
+
+bool ResourceManager::loadImpulseResponse(const juce::File& file, ConvolutionReverb& destination)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples < 1 || reader->sampleRate <= 0.0)
+        return false;
+
+    // Only the first two channels; anything past the longest response is cut
+    const auto maxLength = (juce::int64) std::ceil(ConvolutionReverb::maxImpulseSeconds * reader->sampleRate);
+    const int numSamples = (int) juce::jmin(reader->lengthInSamples, maxLength);
+    const int numChannels = (int) juce::jlimit(1u, 2u, reader->numChannels);
+
+    juce::AudioBuffer<float> response(numChannels, numSamples);
+    if (!reader->read(&response, 0, numSamples, 0, true, numChannels > 1))
+        return false;
+
+    destination.setImpulseResponse(response, reader->sampleRate);
+    return true;
+}
+
+void ResourceManager::loadImpulseResponseAsync(const juce::File& file, ConvolutionReverb& destination,
+                                               std::function<void(bool)> onFinished)
+{
+    if (impulseLoader == nullptr)
+        impulseLoader = std::make_unique<ImpulseLoader>(*this);
+
+    impulseLoader->request(file, destination, std::move(onFinished));
+}
+
+void ResourceManager::loadSample(const juce::File& file) {
+    // Load sample from file
+}
@@ -1,9 +1,69 @@
 #pragma once
-// This line is already present, so we will not add it again.
 #include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <atomic>
+#include <functional>
+#include "../DSP/WaveTableBank.h"
+#include "../DSP/FX/ConvolutionReverb.h"
+
+/**
+ * ResourceManager - Loads user content from disk for one plugin instance.
+ * Loading runs on the message thread, or on a background loader for impulse
+ * responses; the audio thread only ever sees the finished, read-only result.
+ *
+ * An imported wavetable is handed to the audio thread through pendingUserTable
+ * and made current by takeUserTable() at a control tick. The table it replaces
+ * stays alive while the oscillators fade out of it, is then handed back through
+ * retiredUserTable and freed by the next import, so at most four tables ever
+ * exist: current, outgoing, retired and pending.
+ */
 class ResourceManager {
 public:
+    using WaveTable = WaveTableBank::WaveTable;
+
     ResourceManager();
-    void loadWavetable(const juce::File& file);
+    ~ResourceManager();
+
+    // Imports a single-cycle (or the first 2048-sample frame of a multi-frame)
+    // wavetable as this instance's user table. Returns false if the file can't be read.
+    bool loadWavetable(const juce::File& file);
+
+    // Audio thread: the imported table the oscillators play, nullptr until one is loaded
+    const WaveTable* getUserTable() const { return userTable; }
+
+    // Audio thread: the table the last takeUserTable() replaced, until it is retired
+    const WaveTable* getOutgoingUserTable() const { return outgoingUserTable; }
+
+    // Audio thread: makes a newly imported table current. Waits while the previous
+    // replacement is still outgoing; returns true if the table changed.
+    bool takeUserTable();
+
+    // Audio thread: hands the outgoing table back once nothing reads it anymore
+    void retireOutgoingUserTable();
+
+    // Reads up to ConvolutionReverb::maxImpulseSeconds of a mono or stereo impulse response
+    // and hands it to the convolver, which resamples it to the engine rate. Blocks until the
+    // response is built; returns false if the file can't be read.
+    bool loadImpulseResponse(const juce::File& file, ConvolutionReverb& destination);
+
+    // The same on a background thread, so a long response never stalls the message thread.
+    // onFinished is called on the message thread with the result. A request still waiting
+    // is replaced by a newer one. destination must outlive this ResourceManager.
+    void loadImpulseResponseAsync(const juce::File& file, ConvolutionReverb& destination,
+                                  std::function<void(bool)> onFinished);
     void loadSample(const juce::File& file);
+
+private:
+    class ImpulseLoader;
+
+    juce::AudioFormatManager formatManager;
+
+    std::atomic<WaveTable*> pendingUserTable { nullptr }; // Imported, not picked up yet
+    std::atomic<WaveTable*> retiredUserTable { nullptr }; // Let go of by the audio thread, freed on the next import
+    WaveTable* userTable = nullptr; // Audio thread
+    WaveTable* outgoingUserTable = nullptr; // Audio thread: replaced, the oscillators may still fade out of it
+
+    std::unique_ptr<ImpulseLoader> impulseLoader; // Created with the first request, stopped first on destruction
+
+    JUCE_DECLARE_NON_COPYABLE(ResourceManager)
 };
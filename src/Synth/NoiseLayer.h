@@ -1,19 +1,23 @@
 #pragma once
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
-#include <random>
+#include "SynthLayer.h"
+#include "../DSP/VoidOscillator.h"
+#include "../DSP/StateVariableFilterBank.h"
+#include "../DSP/NoiseGenerator.h"
 
-class NoiseLayer : public juce::AudioSource {
+class NoiseLayer : public SynthLayer {
 public:
     NoiseLayer();
     ~NoiseLayer() override;
 
     void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
     void releaseResources() override;
-    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void render(float* left, float* right, int numSamples) override; // Mono - right is unused
+    void controlTick() override; // Advances the filter LFO
 
     // Enhanced noise parameters for ambient pads
-    void setNoiseType(int type); // 0=white, 1=pink, 2=brown
+    void setNoiseType(int type); // NoiseGenerator::Type - 0=white, 1=pink, 2=brown, 3=blue
     void setFilterFrequency(float frequency); // Center frequency for bandpass
     void setFilterModulation(float depth); // LFO modulation depth
     void setLevel(float level); // Noise layer level (0.0 - 1.0)
@@ -21,34 +25,21 @@ public:
     void setActive(bool isActive); // Control if layer should produce sound
 
 private:
-    // Noise generation
-    std::random_device rd;
-    std::mt19937 gen;
-    std::uniform_real_distribution<float> dist;
-    
-    // Pink noise filter coefficients
-    float pinkState[7] = {0};
+    // Noise generation - per-instance state, type switched through an atomic
+    NoiseGenerator generator;
     
     // Filtering for atmospheric texture
-    juce::dsp::StateVariableTPTFilter<float> bandpassFilter;
-    juce::dsp::Oscillator<float> filterLFO;
+    StateVariableFilterBank bandpassFilter;
+    juce::SharedResourcePointer<WaveTableBank> waveTables;
+    VoidOscillator filterLFO; // Runs at control rate, one sample per engine tile
     
     // Parameters
-    int noiseType = 1; // Default to pink noise for natural texture
     float filterFrequency = 3000.0f; // Upper mid-range for air
     float filterModDepth = 0.3f; // Subtle modulation
     float noiseLevel = 0.2f; // Subtle level (10-30% as recommended)
     float atmosphereAmount = 0.5f;
     
-    // Thread safety
-    juce::SpinLock noiseTypeLock;
-    
     // Internal state
     double sampleRate = 44100.0;
     bool isActive = false; // Only play when note is active
-    
-    // Helper methods
-    float generateWhiteNoise();
-    float generatePinkNoise();
-    float generateBrownNoise();
 };
@@ -1,135 +1,284 @@
 #include "OscillatorLayer.h"
+#include "../DSP/Kernels/DspKernels.h"
+#include "../DSP/LayerMixer.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
 
+namespace
+{
+    // Mip levels are stored back to back, so one base pointer plus a per-lane
+    // offset reaches any level - the form SIMD gathers need
+    constexpr int levelStride = WaveTableBank::tableSize + 1;
+    static_assert(sizeof(WaveTableBank::WaveTable::Level) == levelStride * sizeof(float));
+
+    // The kernels see the unison rows as one [oscillator][voice] array
+    static_assert(sizeof(std::array<std::array<float, OscillatorLayer::maxVoices>, OscillatorLayer::maxUnison>)
+                  == OscillatorLayer::maxUnison * OscillatorLayer::maxVoices * sizeof(float));
+    static_assert(OscillatorLayer::maxVoices == DspKernels::numLanes);
+
+    constexpr int crossfadeSamples = 256;
+}
+
 OscillatorLayer::OscillatorLayer()
 {
-    // Initialize all three oscillators with triangle waves for ambient pads
-    oscillator1.initialise(triangleWave, 128);
-    oscillator2.initialise(triangleWave, 128);
-    oscillator3.initialise(triangleWave, 128);
-    
-    // Set initial frequencies with slight detuning for rich harmonics
-    updateOscillatorFrequencies();
-    
-    // Configure lowpass filter for smooth pad character
-    lowpassFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    lowpassFilter.setCutoffFrequency(1200.0f);
-    lowpassFilter.setResonance(0.3f);
+    // Initialize every voice with triangle waves for ambient pads
+    currentTable = waveTables->getTable(waveformType);
+    previousWaveformType = waveformType;
+
+    // Slight detuning between the unison oscillators for rich harmonics
+    updateDetuneRatios();
+    updateUnisonGains();
 }
 
 OscillatorLayer::~OscillatorLayer() {}
 
 void OscillatorLayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
+    juce::ignoreUnused(samplesPerBlockExpected);
     this->sampleRate = sampleRate;
-    
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlockExpected);
-    spec.numChannels = 1;
-    
-    // Prepare all oscillators and filter
-    oscillator1.prepare(spec);
-    oscillator2.prepare(spec);
-    oscillator3.prepare(spec);
-    lowpassFilter.prepare(spec);
+
+    // One filter lane per voice and side
+    filter.prepare(sampleRate);
+    filterRight.prepare(sampleRate);
+    crossfadeRemaining = 0;
+
+    for (int voice = 0; voice < maxVoices; ++voice)
+        updateVoiceFrequencies(voice);
 }
 
 void OscillatorLayer::releaseResources()
 {
-    oscillator1.reset();
-    oscillator2.reset();
-    oscillator3.reset();
-    lowpassFilter.reset();
+    for (auto& row : phases)
+        row.fill(0.0f);
+    filter.reset();
+    filterRight.reset();
 }
 
-void OscillatorLayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+void OscillatorLayer::render(float* left, float* right, int numSamples)
 {
-    auto* left = bufferToFill.buffer->getWritePointer(0, bufferToFill.startSample);
-    auto* right = bufferToFill.buffer->getNumChannels() > 1 ? bufferToFill.buffer->getWritePointer(1, bufferToFill.startSample) : nullptr;
-    
-    for (int i = 0; i < bufferToFill.numSamples; ++i)
+    // Only generate sound while at least one voice is playing
+    if (!isAnyVoiceActive()) {
+        crossfadeRemaining = 0; // Nothing audible to fade out of
+        juce::FloatVectorOperations::clear(left, numSamples);
+        if (right != nullptr)
+            juce::FloatVectorOperations::clear(right, numSamples);
+        return;
+    }
+
+    const auto& kernels = DspKernels::get();
+    const bool stereo = right != nullptr;
+
+    // The right filter sits idle while the layer renders mono. At zero spread both sides
+    // carry the mono signal, so it takes over the left filter's state and glides on from there.
+    if (stereo && !renderedStereo)
+        filterRight = filter;
+    renderedStereo = stereo;
+
+    alignas(32) float framesLeft[frameBlockSize * maxVoices];
+    alignas(32) float framesRight[frameBlockSize * maxVoices];
+
+    // Fade weight runs from crossfadeRemaining / crossfadeSamples down to zero
+    const float fadeStep = 1.0f / (float) crossfadeSamples;
+
+    for (int offset = 0; offset < numSamples; offset += frameBlockSize)
     {
-        float finalSample = 0.0f;
-        
-        // Only generate sound if layer is active (note is pressed)
-        if (isActive)
+        const int n = juce::jmin(frameBlockSize, numSamples - offset);
+        juce::FloatVectorOperations::clear(framesLeft, n * maxVoices);
+        if (stereo)
+            juce::FloatVectorOperations::clear(framesRight, n * maxVoices);
+
+        // Every unison oscillator of every voice in one kernel call
+        const float* rowLeftGains = stereo ? leftGains.data() : monoGains.data();
+        const float startFade = (float) crossfadeRemaining * fadeStep;
+
+        if (mode == analytic)
+        {
+            const DspKernels::PolyBlepLanes lanes {
+                phases[0].data(), increments[0].data(), voiceGains.data(),
+                rowLeftGains, rightGains.data(), numUnison,
+                waveformType, previousWaveformType, startFade, fadeStep
+            };
+
+            kernels.polyBlepFrames(lanes, framesLeft, stereo ? framesRight : nullptr, n);
+        }
+        else
+        {
+            jassert(currentTable != nullptr);
+
+            const DspKernels::WavetableLanes lanes {
+                currentTable->levels[0].data(),
+                previousTable != nullptr ? previousTable->levels[0].data() : nullptr,
+                startFade, fadeStep,
+                phases[0].data(), increments[0].data(), levelOffsets[0].data(), voiceGains.data(),
+                rowLeftGains, rightGains.data(), numUnison,
+                WaveTableBank::tableSize
+            };
+
+            kernels.wavetableFrames(lanes, framesLeft, stereo ? framesRight : nullptr, n);
+        }
+
+        crossfadeRemaining = juce::jmax(0, crossfadeRemaining - n);
+
+        // Voice filter, all voices in one pass; the envelope doubles as its sweep
+        const float* sweep = envelopeFrames != nullptr ? envelopeFrames + offset * maxVoices : nullptr;
+        filter.processInterleaved(framesLeft, n, sweep);
+        if (stereo)
+            filterRight.processInterleaved(framesRight, n, sweep);
+
+        // Gate free voices, apply the envelope and the layer level and sum,
+        // tracking each voice's peak on the way
+        for (int i = 0; i < n; ++i)
         {
-            // Mix multiple detuned oscillators for rich harmonic content
-            float sample1 = oscillator1.processSample(0.0f);
-            float sample2 = oscillator2.processSample(0.0f);
-            float sample3 = oscillator3.processSample(0.0f);
-            
-            // Energy-based mixing to prevent level buildup
-            float mixedSample = (sample1 + sample2 + sample3) * (1.0f / std::sqrt(3.0f));
-            
-            // Apply lowpass filtering for smooth pad character
-            float tempSample = mixedSample;
-            float* channelPointer = &tempSample;
-            auto block = juce::dsp::AudioBlock<float>(&channelPointer, 1, 1);
-            auto context = juce::dsp::ProcessContextReplacing<float>(block);
-            lowpassFilter.process(context);
-            float filteredSample = tempSample;
-            
-            // Apply layer level
-            finalSample = filteredSample * layerLevel;
+            const float* frameLeft = framesLeft + i * maxVoices;
+            const float* frameRight = framesRight + i * maxVoices;
+            const float* envelope = envelopeFrames != nullptr ? envelopeFrames + (offset + i) * maxVoices
+                                                              : unityFrame.data();
+            float sumLeft = 0.0f;
+            float sumRight = 0.0f;
+
+            for (int v = 0; v < maxVoices; ++v)
+            {
+                const float gain = voiceGains[(size_t) v] * envelope[v] * layerLevel;
+
+                const float sampleLeft = frameLeft[v] * gain;
+                const float sampleRight = stereo ? frameRight[v] * gain : 0.0f;
+                sumLeft += sampleLeft;
+                sumRight += sampleRight;
+
+                const float peak = juce::jmax(std::abs(sampleLeft), std::abs(sampleRight));
+                voiceLevels[(size_t) v] = juce::jmax(voiceLevels[(size_t) v], peak);
+            }
+
+            left[offset + i] = sumLeft;
+            if (stereo)
+                right[offset + i] = sumRight;
         }
-        
-        left[i] = finalSample;
-        if (right) right[i] = finalSample;
     }
 }
 
-void OscillatorLayer::setFrequency(float frequency)
+void OscillatorLayer::startVoice(int voice, float frequency)
 {
-    currentFrequency = frequency;
-    updateOscillatorFrequencies();
+    jassert(juce::isPositiveAndBelow(voice, maxVoices));
+
+    frequencies[(size_t) voice] = frequency;
+    voiceGains[(size_t) voice] = 1.0f;
+    voiceLevels[(size_t) voice] = 0.0f;
+    previousVoiceLevels[(size_t) voice] = 0.0f;
+
+    // Every row gets a start phase, so raising the unison count mid-note stays consistent
+    for (auto& row : phases)
+        row[(size_t) voice] = random.nextFloat() * phaseRandomness;
+
+    // The lane may still hold the previous note's filter state
+    for (auto* voiceFilter : { &filter, &filterRight })
+    {
+        voiceFilter->setNoteFrequency(voice, frequency);
+        voiceFilter->resetLane(voice);
+    }
+
+    updateVoiceFrequencies(voice);
+}
+
+void OscillatorLayer::stopVoice(int voice)
+{
+    jassert(juce::isPositiveAndBelow(voice, maxVoices));
+
+    voiceGains[(size_t) voice] = 0.0f;
+    voiceLevels[(size_t) voice] = 0.0f;
+    previousVoiceLevels[(size_t) voice] = 0.0f;
 }
 
-void OscillatorLayer::setWaveform(int type)
+void OscillatorLayer::controlTick()
 {
+    // Levels cover whole tiles, so a short MIDI-split render can't read as silence
+    previousVoiceLevels = voiceLevels;
+    voiceLevels.fill(0.0f);
+}
+
+void OscillatorLayer::setWaveform(int type, const WaveTableBank::WaveTable* userTable)
+{
+    // Compare tables rather than indices so a reloaded user table is picked up
+    const auto* table = type == WaveTableBank::user && userTable != nullptr ? userTable : waveTables->getTable(type);
+    if (table == currentTable)
+        return;
+
+    // Tables are prebuilt and shared, so switching is a pointer swap with a short crossfade.
+    // Analytic mode fades between the two shapes instead.
+    previousWaveformType = waveformType;
     waveformType = type;
-    switch (type)
-    {
-        case 0: // Sine
-            oscillator1.initialise([](float x) { return std::sin(x); }, 128);
-            oscillator2.initialise([](float x) { return std::sin(x); }, 128);
-            oscillator3.initialise([](float x) { return std::sin(x); }, 128);
-            break;
-        case 1: // Saw (detuned for ambient pads)
-            oscillator1.initialise([](float x) { return x / juce::MathConstants<float>::pi; }, 128);
-            oscillator2.initialise([](float x) { return x / juce::MathConstants<float>::pi; }, 128);
-            oscillator3.initialise([](float x) { return x / juce::MathConstants<float>::pi; }, 128);
-            break;
-        case 2: // Triangle (recommended for ambient pads)
-            oscillator1.initialise(triangleWave, 128);
-            oscillator2.initialise(triangleWave, 128);
-            oscillator3.initialise(triangleWave, 128);
-            break;
-        case 3: // Square
-            oscillator1.initialise([](float x) { return x < 0.0f ? -1.0f : 1.0f; }, 128);
-            oscillator2.initialise([](float x) { return x < 0.0f ? -1.0f : 1.0f; }, 128);
-            oscillator3.initialise([](float x) { return x < 0.0f ? -1.0f : 1.0f; }, 128);
-            break;
-        default:
-            oscillator1.initialise(triangleWave, 128);
-            oscillator2.initialise(triangleWave, 128);
-            oscillator3.initialise(triangleWave, 128);
-            break;
-    }
+    previousTable = currentTable;
+    crossfadeRemaining = previousTable != nullptr && isAnyVoiceActive() ? crossfadeSamples : 0;
+    currentTable = table;
+}
+
+void OscillatorLayer::setMode(int newMode)
+{
+    if (newMode == mode)
+        return;
+
+    // Restart the phases so the newly selected oscillators begin from the same point
+    mode = newMode;
+    for (auto& row : phases)
+        row.fill(0.0f);
+}
+
+void OscillatorLayer::setUnison(int numOscillators)
+{
+    numOscillators = juce::jlimit(1, maxUnison, numOscillators);
+    if (numOscillators == numUnison)
+        return;
+
+    numUnison = numOscillators;
+    updateDetuneRatios();
+    updateUnisonGains();
 }
 
 void OscillatorLayer::setDetune(float cents)
 {
     detuneAmount = cents;
-    updateOscillatorFrequencies();
+    updateDetuneRatios();
+}
+
+void OscillatorLayer::setDetuneCurve(float curve)
+{
+    detuneCurve = juce::jlimit(0.0f, 1.0f, curve);
+    updateDetuneRatios();
+}
+
+void OscillatorLayer::setStereoSpread(float spread)
+{
+    stereoSpread = juce::jlimit(0.0f, 1.0f, spread);
+    updateUnisonGains();
+}
+
+void OscillatorLayer::setPhaseRandomness(float amount)
+{
+    // Takes effect from the next note
+    phaseRandomness = juce::jlimit(0.0f, 1.0f, amount);
 }
 
-void OscillatorLayer::setVoiceSpread(float spread)
+void OscillatorLayer::setFilterCutoff(float frequency)
 {
-    voiceSpread = spread;
-    updateOscillatorFrequencies();
+    filter.setCutoffFrequency(frequency);
+    filterRight.setCutoffFrequency(frequency);
+}
+
+void OscillatorLayer::setFilterResonance(float amount)
+{
+    filter.setResonance(amount);
+    filterRight.setResonance(amount);
+}
+
+void OscillatorLayer::setFilterKeyTracking(float amount)
+{
+    filter.setKeyTracking(amount);
+    filterRight.setKeyTracking(amount);
+}
+
+void OscillatorLayer::setFilterEnvelopeAmount(float octaves)
+{
+    filter.setModulationDepth(octaves);
+    filterRight.setModulationDepth(octaves);
 }
 
 void OscillatorLayer::setLevel(float level)
@@ -137,37 +286,63 @@ void OscillatorLayer::setLevel(float level)
     layerLevel = juce::jlimit(0.0f, 1.0f, level);
 }
 
-void OscillatorLayer::setActive(bool active)
+float OscillatorLayer::getUnisonPosition(int index) const
 {
-    isActive = active;
+    return numUnison > 1 ? 2.0f * (float) index / (float) (numUnison - 1) - 1.0f : 0.0f;
 }
 
-void OscillatorLayer::setAttack(float attackMs)
+void OscillatorLayer::updateDetuneRatios()
 {
-    attackTime = attackMs / 1000.0f; // Convert to seconds
+    // Symmetric around the note; the curve bends the spacing from linear towards
+    // cubic, which bunches the inner oscillators and leaves the outer ones wide
+    const float exponent = 1.0f + 2.0f * detuneCurve;
+
+    for (int u = 0; u < numUnison; ++u)
+    {
+        const float position = getUnisonPosition(u);
+        const float shaped = std::copysign(std::pow(std::abs(position), exponent), position);
+        detuneRatios[(size_t) u] = std::pow(2.0f, detuneAmount * shaped / 1200.0f);
+    }
+
+    for (int voice = 0; voice < maxVoices; ++voice)
+        updateVoiceFrequencies(voice);
 }
 
-void OscillatorLayer::setRelease(float releaseMs)
+void OscillatorLayer::updateUnisonGains()
 {
-    releaseTime = releaseMs / 1000.0f; // Convert to seconds
+    // Energy-based mixing to prevent level buildup as oscillators are added
+    const float normalise = 1.0f / std::sqrt((float) numUnison);
+
+    // Constant-power pan from the lowest oscillator on the left to the highest on the
+    // right. At zero spread both sides equal the mono gain, so switching is seamless.
+    for (int u = 0; u < numUnison; ++u)
+    {
+        const float pan = getUnisonPosition(u) * stereoSpread;
+        monoGains[(size_t) u] = normalise;
+        leftGains[(size_t) u] = normalise * LayerMixer::getLeftPanGain(pan);
+        rightGains[(size_t) u] = normalise * LayerMixer::getRightPanGain(pan);
+    }
 }
 
-void OscillatorLayer::setSustain(float sustainLevel)
+void OscillatorLayer::updateVoiceFrequencies(int voice)
 {
-    this->sustainLevel = juce::jlimit(0.0f, 1.0f, sustainLevel);
+    // Ratios are cached in updateDetuneRatios(), so a note change costs no pow()
+    for (int u = 0; u < numUnison; ++u)
+    {
+        const float frequency = frequencies[(size_t) voice] * detuneRatios[(size_t) u];
+
+        // Kept above zero so the PolyBLEP width never divides by zero
+        const float increment = juce::jlimit(1.0e-6f, 0.5f, (float) (frequency / sampleRate));
+
+        increments[(size_t) u][(size_t) voice] = increment;
+        levelOffsets[(size_t) u][(size_t) voice] = WaveTableBank::getMipLevelForIncrement(increment) * levelStride;
+    }
 }
 
-void OscillatorLayer::updateOscillatorFrequencies()
+bool OscillatorLayer::isAnyVoiceActive() const
 {
-    // Calculate detuned frequencies for rich harmonic content
-    // Oscillator 1: Base frequency
-    oscillator1.setFrequency(currentFrequency);
-    
-    // Oscillator 2: Slightly detuned up (+5-10 cents)
-    float detuneFactor2 = std::pow(2.0f, (detuneAmount * 0.5f) / 1200.0f);
-    oscillator2.setFrequency(currentFrequency * detuneFactor2);
-    
-    // Oscillator 3: Slightly detuned down (-3-7 cents)
-    float detuneFactor3 = std::pow(2.0f, (-detuneAmount * 0.7f) / 1200.0f);
-    oscillator3.setFrequency(currentFrequency * detuneFactor3);
+    for (auto gain : voiceGains)
+        if (gain > 0.0f)
+            return true;
+    return false;
 }
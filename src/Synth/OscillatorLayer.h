@@ -1,59 +1,152 @@
 #pragma once
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
+#include "SynthLayer.h"
+#include "../DSP/WaveTableBank.h"
+#include "../DSP/DarkFilter.h"
 
-class OscillatorLayer : public juce::AudioSource {
+/**
+ * OscillatorLayer - The oscillator layer of up to eight voices, as one bank.
+ *
+ * Voice state is stored structure-of-arrays with one SIMD lane per voice:
+ * phases, increments and mip levels of every unison oscillator, and the
+ * filter integrators. Every kernel (table reads, PolyBLEP, the ladder) works on
+ * interleaved [sample][voice] frames, so each instruction advances all eight
+ * voices. Free lanes are computed too but gated to silence - pads keep most
+ * lanes busy, and it keeps the kernels branch-free. The loops themselves are
+ * DspKernels, built for the widest instruction set the CPU has.
+ *
+ * Each voice plays 1-16 unison oscillators, stored as rows of the same
+ * arrays: one kernel call runs every row as a phase accumulator, whatever
+ * the unison count. Rows are detuned symmetrically around the note along a
+ * curve, panned across the stereo field by the spread and can start from
+ * random phases.
+ *
+ * render() writes the sum of every playing voice, in stereo when given a
+ * right channel. Each voice runs through its own DarkFilter ladder, the main
+ * voice filter, and is then scaled by its lane of the envelope frames set
+ * with setEnvelopeFrames(). The same frames can sweep the filter cutoff. Waveform, mode and unison are shared by all voices, so they
+ * are set once per bank, not per voice.
+ */
+class OscillatorLayer : public SynthLayer {
 public:
+    static constexpr int maxVoices = DarkFilter::maxLanes;
+    static constexpr int maxUnison = 16; // Unison oscillators per voice
+
+    // Matches the "osc1Mode" parameter choices
+    enum Mode
+    {
+        wavetable = 0, // Mipmapped tables from the shared WaveTableBank
+        analytic       // Table-free PolyBLEP/PolyBLAMP, lower memory traffic
+    };
+
     OscillatorLayer();
     ~OscillatorLayer() override;
 
     void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
     void releaseResources() override;
-    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void render(float* left, float* right, int numSamples) override; // right may be nullptr for a mono sum
+    void controlTick() override;
+
+    // Voice lifecycle
+    void startVoice(int voice, float frequency);
+    void stopVoice(int voice); // Silences the voice immediately
+    bool isVoiceActive(int voice) const { return voiceGains[(size_t) voice] > 0.0f; }
+
+    // Whether the layer plays a table or is still fading out of it
+    bool isUsingTable(const WaveTableBank::WaveTable* table) const
+    {
+        return table == currentTable || (table == previousTable && crossfadeRemaining > 0);
+    }
+
+    // Peak over the current and the previous control tile
+    float getVoiceLevel(int voice) const
+    {
+        return juce::jmax(voiceLevels[(size_t) voice], previousVoiceLevels[(size_t) voice]);
+    }
+
+    // Envelope for the next render() call, frames[i * maxVoices + voice] as written
+    // by EnvelopeBank; nullptr plays every voice at full level
+    void setEnvelopeFrames(const float* frames) { envelopeFrames = frames; }
 
-    // Enhanced oscillator parameters for ambient pads
-    void setFrequency(float frequency);
-    void setWaveform(int type); // 0=sine, 1=saw, 2=triangle, 3=square
-    void setDetune(float cents); // Detune amount in cents
-    void setVoiceSpread(float spread); // Spread between multiple oscillators
+    // Enhanced oscillator parameters for ambient pads, shared by every voice
+    void setWaveform(int type, const WaveTableBank::WaveTable* userTable); // WaveTableBank::Waveform - 0=saw, 1=square, 2=triangle, 3=sine, 4=user; userTable nullptr plays sine
+    void setMode(int newMode); // Mode - wavetable or analytic
     void setLevel(float level); // Layer level (0.0 - 1.0)
-    void setActive(bool isActive); // Control if layer should produce sound
-    
-    // Ambient pad specific parameters
-    void setAttack(float attackMs);
-    void setRelease(float releaseMs);
-    void setSustain(float sustainLevel);
+
+    // Unison
+    void setUnison(int numOscillators); // Oscillators per voice (1 - 16)
+    void setDetune(float cents); // Detune of the outermost oscillators in cents
+    void setDetuneCurve(float curve); // 0 = evenly spaced, 1 = clustered at the note with wide outer oscillators
+    void setStereoSpread(float spread); // 0 = mono, 1 = outermost oscillators panned hard left/right
+    void setPhaseRandomness(float amount); // 0 = every oscillator starts at phase 0, 1 = fully random
+
+    // Voice filter
+    void setFilterCutoff(float frequency); // At middle C, or for every note without key tracking
+    void setFilterResonance(float amount); // 0 - 1, self-oscillates at 1
+    void setFilterKeyTracking(float amount); // 0 - 1
+    void setFilterEnvelopeAmount(float octaves); // Cutoff sweep at full envelope level
 
 private:
-    // Multiple detuned oscillators for rich harmonic content
-    juce::dsp::Oscillator<float> oscillator1;
-    juce::dsp::Oscillator<float> oscillator2;
-    juce::dsp::Oscillator<float> oscillator3;
-    
-    // ADSR envelope for pad-like behavior
-    juce::dsp::StateVariableTPTFilter<float> lowpassFilter;
-    
+    static constexpr int frameBlockSize = DarkFilter::controlInterval;
+
+    // Built-in waveform tables shared by every voice and plugin instance
+    juce::SharedResourcePointer<WaveTableBank> waveTables;
+
+    // Waveform switches crossfade from the previous table or shape for every voice at once
+    const WaveTableBank::WaveTable* currentTable = nullptr;
+    const WaveTableBank::WaveTable* previousTable = nullptr;
+    int previousWaveformType = WaveTableBank::triangle;
+    int crossfadeRemaining = 0;
+
+    // Per-voice state, lane v belongs to voice v
+    alignas(32) std::array<float, maxVoices> frequencies {};
+    alignas(32) std::array<float, maxVoices> voiceGains {}; // 1 while playing, 0 when free
+    alignas(32) std::array<float, maxVoices> voiceLevels {}; // Peak since the last control tick
+    alignas(32) std::array<float, maxVoices> previousVoiceLevels {};
+
+    // Envelope, applied after the filter so its tail follows the release too
+    const float* envelopeFrames = nullptr;
+    static constexpr auto unityFrame = [] { std::array<float, maxVoices> frame {}; frame.fill(1.0f); return frame; }();
+
+    // Phase, increment and mip level offset per unison oscillator (row) and voice (lane)
+    alignas(32) std::array<std::array<float, maxVoices>, maxUnison> phases {};
+    alignas(32) std::array<std::array<float, maxVoices>, maxUnison> increments {};
+    alignas(32) std::array<std::array<int, maxVoices>, maxUnison> levelOffsets {};
+
+    // Per unison oscillator: frequency ratio, and gain in a mono sum or on each side
+    std::array<float, maxUnison> detuneRatios {};
+    std::array<float, maxUnison> monoGains {};
+    std::array<float, maxUnison> leftGains {};
+    std::array<float, maxUnison> rightGains {};
+
+    int mode = wavetable;
+
+    // Voice filter, one lane per voice and side
+    DarkFilter filter;
+    DarkFilter filterRight; // Only runs for stereo renders
+    bool renderedStereo = false;
+
     // Parameters
-    float currentFrequency = 440.0f;
-    int waveformType = 2; // Default to triangle for smooth pads
+    int waveformType = WaveTableBank::triangle; // Default to triangle for smooth pads
+    int numUnison = 3;
     float detuneAmount = 5.0f; // Slight detune in cents
-    float voiceSpread = 10.0f; // Spread between oscillators
+    float detuneCurve = 0.0f;
+    float stereoSpread = 0.0f;
+    float phaseRandomness = 0.0f;
     float layerLevel = 0.7f;
-    
-    // Envelope parameters (in samples)
-    float attackTime = 2.0f; // 2 second attack
-    float releaseTime = 4.0f; // 4 second release
-    float sustainLevel = 0.8f;
-    
+
+    juce::Random random;
+
     // Internal state
     double sampleRate = 44100.0;
-    bool isActive = false; // Only play when note is active
-    
+
     // Helper methods
-    void updateOscillatorFrequencies();
-    
-    // Triangle wave function for smooth harmonic content
-    static float triangleWave(float x) {
-        return std::asin(std::sin(x)) * (2.0f / juce::MathConstants<float>::pi);
-    }
+    void updateDetuneRatios(); // Also refreshes every voice's increments
+    void updateUnisonGains();
+    void updateVoiceFrequencies(int voice);
+    bool isAnyVoiceActive() const;
+
+    // Position of unison oscillator index in [-1, 1], from lowest to highest
+    float getUnisonPosition(int index) const;
 };
@@ -17,11 +17,15 @@ void SamplerLayer::releaseResources() {
     readerSource.reset();
 }
 
-void SamplerLayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) {
+void SamplerLayer::render(float* left, float* right, int numSamples) {
+    // Wrap the caller's channels - referring to existing memory doesn't allocate
+    float* channels[] = { left, right };
+    juce::AudioBuffer<float> buffer(channels, right != nullptr ? 2 : 1, numSamples);
+
     if (readerSource)
-        readerSource->getNextAudioBlock(bufferToFill);
+        readerSource->getNextAudioBlock(juce::AudioSourceChannelInfo(&buffer, 0, numSamples));
     else
-        bufferToFill.clearActiveBufferRegion();
+        buffer.clear();
 }
 
 void SamplerLayer::loadSample(const juce::File& file) {
@@ -2,15 +2,19 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_formats/juce_audio_formats.h>
+#include "SynthLayer.h"
 
-class SamplerLayer : public juce::AudioSource {
+class SamplerLayer : public SynthLayer {
 public:
     SamplerLayer();
     ~SamplerLayer() override;
 
     void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
     void releaseResources() override;
-    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void render(float* left, float* right, int numSamples) override;
+
+    // Samples are played back with their own stereo image
+    bool isStereo() const override { return true; }
 
     // Load sample
     void loadSample(const juce::File& file);
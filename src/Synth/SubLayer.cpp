@@ -5,11 +5,11 @@
 SubLayer::SubLayer()
 {
     // Initialize dual sub oscillators with sine waves for clean low-end
-    subOscillator1.initialise([](float x) { return std::sin(x); }, 128);
-    subOscillator2.initialise([](float x) { return std::sin(x); }, 128);
+    subOscillator1.setTable(waveTables->getTable(WaveTableBank::sine));
+    subOscillator2.setTable(waveTables->getTable(WaveTableBank::sine));
     
     // Configure low-pass filter for sub-bass focus (40-120Hz range)
-    lowpassFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
+    lowpassFilter.setType(StateVariableFilterBank::Type::lowpass);
     lowpassFilter.setCutoffFrequency(120.0f); // Sharp cutoff for sub-bass only
     lowpassFilter.setResonance(0.1f); // Very low resonance to avoid muddiness
     
@@ -20,17 +20,13 @@ SubLayer::~SubLayer() {}
 
 void SubLayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
+    juce::ignoreUnused(samplesPerBlockExpected);
     this->sampleRate = sampleRate;
-    
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlockExpected);
-    spec.numChannels = 1;
 
     // Prepare both oscillators and filter
-    subOscillator1.prepare(spec);
-    subOscillator2.prepare(spec);
-    lowpassFilter.prepare(spec);
+    subOscillator1.prepare(sampleRate);
+    subOscillator2.prepare(sampleRate);
+    lowpassFilter.prepare(sampleRate);
 }
 
 void SubLayer::releaseResources()
@@ -40,40 +36,24 @@ void SubLayer::releaseResources()
     lowpassFilter.reset();
 }
 
-void SubLayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+void SubLayer::render(float* left, float* right, int numSamples)
 {
+    juce::ignoreUnused(right);
+    
     // If not active, clear buffer and return
     if (!isActive) {
-        bufferToFill.clearActiveBufferRegion();
+        juce::FloatVectorOperations::clear(left, numSamples);
         return;
     }
     
-    auto* left = bufferToFill.buffer->getWritePointer(0, bufferToFill.startSample);
-    auto* right = bufferToFill.buffer->getNumChannels() > 1 ? bufferToFill.buffer->getWritePointer(1, bufferToFill.startSample) : nullptr;
+    // Mix the dual sub oscillators for richness
+    juce::FloatVectorOperations::clear(left, numSamples);
+    subOscillator1.process(left, numSamples, 1.0f);
+    subOscillator2.process(left, numSamples, harmonicsAmount);
     
-    for (int i = 0; i < bufferToFill.numSamples; ++i)
-    {
-        // Generate dual sub oscillators for richness
-        float subSample1 = subOscillator1.processSample(0.0f);
-        float subSample2 = subOscillator2.processSample(0.0f) * harmonicsAmount;
-        
-        // Mix the sub oscillators
-        float mixedSub = subSample1 + subSample2;
-        
-        // Apply low-pass filtering to focus on sub-bass frequencies
-        float tempSample = mixedSub;
-        float* channelPointer = &tempSample;
-        auto block = juce::dsp::AudioBlock<float>(&channelPointer, 1, 1);
-        auto context = juce::dsp::ProcessContextReplacing<float>(block);
-        lowpassFilter.process(context);
-        float filteredSub = tempSample;
-        
-        // Apply warmth and level control
-        float finalSample = filteredSub * subLevel * warmthAmount;
-        
-        left[i] = finalSample;
-        if (right) right[i] = finalSample;
-    }
+    // Apply low-pass filtering to focus on sub-bass frequencies, then warmth and level
+    lowpassFilter.process(left, numSamples);
+    juce::FloatVectorOperations::multiply(left, subLevel * warmthAmount, numSamples);
 }
 
 void SubLayer::setFrequency(float frequency)
@@ -1,15 +1,18 @@
 #pragma once
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
+#include "SynthLayer.h"
+#include "../DSP/VoidOscillator.h"
+#include "../DSP/StateVariableFilterBank.h"
 
-class SubLayer : public juce::AudioSource {
+class SubLayer : public SynthLayer {
 public:
     SubLayer();
     ~SubLayer() override;
 
     void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
     void releaseResources() override;
-    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void render(float* left, float* right, int numSamples) override; // Mono - right is unused
 
     // Enhanced sub parameters for ambient pads
     void setFrequency(float frequency);
@@ -19,12 +22,15 @@ public:
     void setActive(bool isActive); // Control if layer should produce sound
 
 private:
+    // Shared sine table
+    juce::SharedResourcePointer<WaveTableBank> waveTables;
+    
     // Dual sub oscillators for richness
-    juce::dsp::Oscillator<float> subOscillator1; // Primary sub
-    juce::dsp::Oscillator<float> subOscillator2; // Octave down
+    VoidOscillator subOscillator1; // Primary sub
+    VoidOscillator subOscillator2; // Octave down
     
     // Low-pass filtering for sub-bass focus
-    juce::dsp::StateVariableTPTFilter<float> lowpassFilter;
+    StateVariableFilterBank lowpassFilter;
     
     // Parameters
     float subFrequency = 60.0f; // Sub-bass range (40-120Hz)
@@ -0,0 +1,49 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * SynthLayer - Base class for the sound layers of SynthEngine1.
+ *
+ * Layers render mono unless they really are stereo. render() always gets a
+ * left channel; right is only written by layers whose isStereo() is true.
+ * Mono layers reach stereo at the engine's pan stage, so the layer stage
+ * never writes two copies of the same signal.
+ *
+ * getNextAudioBlock() is kept for code that drives a layer as a plain
+ * AudioSource: a mono layer is copied onto every channel there.
+ */
+class SynthLayer : public juce::AudioSource
+{
+public:
+    // Samples between controlTick() calls - the engine's fixed internal tile
+    static constexpr int controlTileSize = 32;
+
+    // Peak level (-120 dB) below which a released voice or an effect tail counts as finished
+    static constexpr float silenceThreshold = 1.0e-6f;
+
+    // True if left and right carry different signals
+    virtual bool isStereo() const { return false; }
+
+    // Writes numSamples to left, and to right if isStereo() and right is not nullptr
+    virtual void render(float* left, float* right, int numSamples) = 0;
+
+    // Called once per engine tile before render(); control-rate modulation goes here
+    virtual void controlTick() {}
+
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override final
+    {
+        auto& buffer = *bufferToFill.buffer;
+        const int numChannels = buffer.getNumChannels();
+        const int start = bufferToFill.startSample;
+        const int numSamples = bufferToFill.numSamples;
+
+        if (numChannels == 0)
+            return;
+
+        float* right = numChannels > 1 ? buffer.getWritePointer(1, start) : nullptr;
+        render(buffer.getWritePointer(0, start), isStereo() ? right : nullptr, numSamples);
+
+        for (int ch = isStereo() ? 2 : 1; ch < numChannels; ++ch)
+            buffer.copyFrom(ch, start, buffer, 0, start, numSamples);
+    }
+};